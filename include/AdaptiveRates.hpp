@@ -0,0 +1,94 @@
+#pragma once
+
+namespace sudoku_ga {
+
+/*
+ * AdaptiveRates - Operator rates that follow what's actually working
+ *
+ * Fixed rates tuned for one kind of puzzle are often wrong for another.
+ * The solver reports how each operator did while building a generation,
+ * and end_generation() adjusts the rates for the next one:
+ *
+ * - Crossover rate: probability matching between "crossover" and "copy the
+ *   parents". Each arm's quality is a moving average of how often its
+ *   children beat their better parent; the crossover rate is crossover's
+ *   share of the total quality (kept between MIN_PROBABILITY and
+ *   1 - MIN_PROBABILITY so neither arm dies out).
+ * - Mutation rate: the "1/5 success rule". If more than a fifth of the
+ *   mutations improve fitness, mutate more; otherwise mutate less.
+ * - Local search candidates: one more if local search often helps, one
+ *   fewer if it rarely does.
+ *
+ * When adaptation is off the solver still reads its rates from here; they
+ * just never change.
+ */
+class AdaptiveRates {
+public:
+    static constexpr double MIN_PROBABILITY = 0.05;
+    static constexpr double MAX_MUTATION_RATE = 0.9;
+    static constexpr int MAX_LOCAL_SEARCH_CANDIDATES = 20;
+
+    // What carries over from one generation to the next (the feedback
+    // counts are always zero between generations). Saved in checkpoints.
+    struct State {
+        double crossover_rate;
+        double mutation_rate;
+        int local_search_candidates;
+        int min_candidates;
+        double crossover_quality;
+        double copy_quality;
+    };
+
+    AdaptiveRates() = default;
+
+    // Start over from the given rates. min_candidates is the smallest
+    // local search that still does something (2 for random swaps); the
+    // candidate count is kept between it and MAX_LOCAL_SEARCH_CANDIDATES.
+    void reset(double crossover_rate, double mutation_rate,
+               int local_search_candidates, int min_candidates);
+
+    // --- Current rates ---
+    double crossover_rate() const { return crossover_rate_; }
+    double mutation_rate() const { return mutation_rate_; }
+    int local_search_candidates() const { return local_search_candidates_; }
+
+    // --- Feedback from the current generation ---
+    // crossed: the child came from crossover (rather than a copy);
+    // improved: it ended up fitter than the better of its parents
+    void record_offspring(bool crossed, bool improved);
+    void record_mutation(bool improved);
+    void record_local_search(bool improved);
+
+    // Add another copy's feedback to ours (children bred in parallel each
+    // record into their own copy, merged before end_generation)
+    void add_feedback(const AdaptiveRates& other);
+
+    // Adapt the rates from this generation's feedback and clear the counts
+    void end_generation();
+
+    // Snapshot and restore, between generations
+    State state() const;
+    void restore(const State& state);
+
+private:
+    double crossover_rate_ = 0.3;
+    double mutation_rate_ = 0.3;
+    int local_search_candidates_ = 2;
+    int min_candidates_ = 2;
+
+    // Moving averages of each arm's success rate
+    double crossover_quality_ = 0.5;
+    double copy_quality_ = 0.5;
+
+    // Counts for the generation being built
+    int crossover_children_ = 0;
+    int crossover_improved_ = 0;
+    int copy_children_ = 0;
+    int copy_improved_ = 0;
+    int mutations_ = 0;
+    int mutations_improved_ = 0;
+    int local_searches_ = 0;
+    int local_searches_improved_ = 0;
+};
+
+} // namespace sudoku_ga
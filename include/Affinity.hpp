@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * Affinity - Keeping worker threads on their own cores
+ *
+ * A GA population is small but touched constantly. If the OS moves a
+ * worker to another core (or, on a multi-socket machine, another socket)
+ * its caches go cold, and memory allocated on one socket is slower to
+ * reach from the other. Pinning each worker to one core avoids both:
+ *
+ * - AffinityPolicy::None     let the OS place threads (the default)
+ * - AffinityPolicy::Compact  fill the cores of one NUMA node before the
+ *                            next (workers share caches and memory)
+ * - AffinityPolicy::Spread   deal workers out across the nodes in turn
+ *                            (uses every socket's memory bandwidth)
+ *
+ * Workers pin themselves before they allocate anything, so the memory
+ * they touch first (their solver, the populations they build) comes from
+ * their own node - Linux places a page on the node that first writes it.
+ *
+ * Only CPUs this process is allowed to use are considered (so taskset and
+ * cgroup limits still apply). Pinning works on Linux; elsewhere, and if
+ * the machine's layout can't be read, the calls do nothing.
+ */
+
+enum class AffinityPolicy {
+    None,
+    Compact,
+    Spread,
+};
+
+// "none", "compact" or "spread"
+const char* affinity_policy_name(AffinityPolicy policy);
+
+// The reverse; throws std::invalid_argument for anything else
+AffinityPolicy parse_affinity_policy(const std::string& name);
+
+// The CPUs this process may run on, grouped by NUMA node (a single group
+// on a machine that isn't NUMA). Read once, on first use.
+const std::vector<std::vector<int>>& cpu_nodes();
+
+// The CPU worker number `worker` should run on, or -1 for no pinning
+int worker_cpu(AffinityPolicy policy, size_t worker);
+
+// Pin the calling thread to worker_cpu(policy, worker). False if the
+// policy is None, or pinning isn't possible here.
+bool pin_current_thread(AffinityPolicy policy, size_t worker);
+
+} // namespace sudoku_ga
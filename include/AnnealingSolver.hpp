@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Chromosome.hpp"
+#include "Solver.hpp"
+#include "SudokuGrid.hpp"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * How the temperature goes down after each step (one Markov chain)
+ *
+ * Geometric:   T = T * cooling_rate
+ * Linear:      T = T - initial_temperature * (1 - cooling_rate)
+ * LundyMees:   T = T / (1 + beta * T), beta = (1 - cooling_rate) / initial_temperature
+ */
+enum class CoolingSchedule {
+    Geometric,
+    Linear,
+    LundyMees,
+};
+
+/*
+ * AnnealingParams - Configuration for the simulated annealing solver
+ */
+struct AnnealingParams {
+    double initial_temperature = 0.0;     // 0 = estimate from the puzzle (std dev of random move costs)
+    double min_temperature = 0.001;       // Reheat (or stop, if reheats are off) below this
+    double cooling_rate = 0.99;           // See CoolingSchedule
+    CoolingSchedule schedule = CoolingSchedule::Geometric;
+    int chain_length = 0;                 // Moves per temperature step (0 = free cells squared)
+    int max_steps = 100000;               // Give up after this many temperature steps
+    int reheat_after = 100;               // Reheat after this many steps without a new best (0 = never)
+    double reheat_fraction = 0.5;         // Reheat to this fraction of the initial temperature
+    int report_interval = 1000;           // Print progress every N steps (0 = quiet)
+};
+
+/*
+ * AnnealingSolver - Simulated annealing on the same representation as the GA
+ *
+ * A single chromosome starts from the same random fill as the GA (every
+ * sub-block valid) and moves by swapping two free cells of one sub-block.
+ * Each move is scored with apply_swap()'s delta: improvements are always
+ * kept, and a move that loses d points is kept with probability exp(-d/T).
+ * When the search stalls, the temperature is raised again (a "reheat").
+ *
+ * SolverResult::generations is the number of temperature steps.
+ *
+ * Usage:
+ *   AnnealingSolver solver;
+ *   SolverResult result = solver.solve(puzzle);
+ */
+template<int Order>
+class BasicAnnealingSolver {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    explicit BasicAnnealingSolver(const AnnealingParams& params = AnnealingParams{});
+
+    Result solve(const Grid& puzzle);
+
+    const AnnealingParams& params() const { return params_; }
+    AnnealingParams& params() { return params_; }
+
+    // Checked once per temperature step; see BasicSolver::set_stop_condition
+    void set_stop_condition(std::function<bool()> should_stop) { should_stop_ = std::move(should_stop); }
+
+private:
+    AnnealingParams params_;
+    std::function<bool()> should_stop_;
+
+    // Free (non-fixed) cells of every sub-block with at least two of them,
+    // computed once per puzzle so moves don't have to rebuild them
+    std::vector<std::vector<int>> free_cells_;
+
+    void find_free_cells(const Grid& puzzle);
+
+    // Random swap of two free cells in a random sub-block
+    CellSwap random_move() const;
+
+    // Starting temperature: std dev of the fitness change of random moves
+    double estimate_temperature(Chromosome& chrom) const;
+
+    double cool(double temperature, double initial_temperature) const;
+};
+
+using AnnealingSolver = BasicAnnealingSolver<3>;
+
+extern template class BasicAnnealingSolver<3>;
+extern template class BasicAnnealingSolver<4>;
+extern template class BasicAnnealingSolver<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SudokuGrid.hpp"
+
+#include <array>
+
+namespace sudoku_ga {
+
+/*
+ * BasicGridTransform - One of the symmetries of Sudoku
+ *
+ * These changes turn a valid puzzle into another valid puzzle, and its
+ * solution into the new puzzle's solution:
+ * - transposing the grid (rows become columns),
+ * - reordering bands, or rows inside a band,
+ * - reordering stacks, or columns inside a stack,
+ * - relabeling the digits.
+ *
+ * A transform stores the combination as lookup tables. Output cell
+ * (row, col) comes from source cell (row_map[row], col_map[col]) of the
+ * (possibly transposed) input, with its digit d replaced by relabel[d].
+ */
+template<int Order>
+struct BasicGridTransform {
+    using Grid = BasicSudokuGrid<Order>;
+    static constexpr int SIZE = Grid::SIZE;
+
+    bool transpose = false;
+    std::array<int, SIZE> row_map{};      // output row -> source row
+    std::array<int, SIZE> col_map{};      // output column -> source column
+    std::array<int, SIZE + 1> relabel{};  // source digit -> output digit (0 stays 0)
+
+    // Fixed cells stay fixed
+    Grid apply(const Grid& grid) const;
+
+    // Undo apply(): maps a grid in the output orientation back to the source
+    Grid invert(const Grid& grid) const;
+};
+
+/*
+ * Find the transform that turns a puzzle into its canonical form: the
+ * smallest puzzle string (reading row by row, empty = 0) that any
+ * symmetry can produce. Equivalent puzzles have the same canonical form,
+ * so it works as a cache key.
+ *
+ * 9x9 puzzles use every symmetry above. With pruning this takes around a
+ * millisecond for normal puzzles, but near-empty grids have so many equal
+ * arrangements that it can take far longer. Larger boards have too many
+ * row/column orderings to try, so they're only canonicalized under
+ * transposing and relabeling - still a valid key, it just matches fewer
+ * equivalent puzzles.
+ */
+template<int Order>
+BasicGridTransform<Order> canonical_transform(const BasicSudokuGrid<Order>& puzzle);
+
+using GridTransform = BasicGridTransform<3>;
+
+extern template struct BasicGridTransform<3>;
+extern template struct BasicGridTransform<4>;
+extern template struct BasicGridTransform<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "AdaptiveRates.hpp"
+#include "Chromosome.hpp"
+#include "SudokuGrid.hpp"
+
+#include <string>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * BasicCheckpoint - Everything a GA run needs to pick up where it stopped
+ *
+ * Taken between generations, so with the same SolverParams a resumed run
+ * makes exactly the same moves as one that was never interrupted: the
+ * population (in order, with fitness), the generation counter, the
+ * adaptive rates and the random generator's state.
+ */
+template<int Order>
+struct BasicCheckpoint {
+    int generation = 0;                 // Last completed generation
+    double elapsed_seconds = 0.0;       // Time spent so far, over all runs
+    AdaptiveRates::State rates{};
+    std::string rng_state;              // RandomGenerator::state()
+    std::vector<BasicChromosome<Order>> individuals;
+};
+
+/*
+ * Binary file format (native byte order, so read it back on the same kind
+ * of machine):
+ *
+ *   "SGAC", version, Order
+ *   generation, elapsed seconds, adaptive rate state
+ *   RNG state (length + text)
+ *   the puzzle: one byte per cell (0 = empty)
+ *   individual count, then per individual: fitness + one byte per cell
+ *
+ * save_checkpoint() writes to "<path>.tmp" and renames it over path, so a
+ * crash while saving never destroys the previous checkpoint.
+ *
+ * load_checkpoint() throws std::runtime_error if the file can't be read,
+ * isn't a checkpoint for this board size, belongs to another puzzle, is
+ * truncated, or is corrupt: a negative generation or time, rates outside
+ * what AdaptiveRates produces, an RNG state that's implausibly long or
+ * doesn't parse, an individual cell that isn't 1..SIZE, an individual
+ * that changes a given, or a stored fitness that doesn't match its grid.
+ */
+template<int Order>
+void save_checkpoint(const std::string& path, const BasicSudokuGrid<Order>& puzzle,
+                     const BasicCheckpoint<Order>& checkpoint);
+
+template<int Order>
+BasicCheckpoint<Order> load_checkpoint(const std::string& path,
+                                       const BasicSudokuGrid<Order>& puzzle);
+
+using Checkpoint = BasicCheckpoint<3>;
+
+} // namespace sudoku_ga
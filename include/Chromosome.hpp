@@ -5,34 +5,39 @@
 namespace sudoku_ga {
 
 /*
- * Chromosome - A candidate solution in our genetic algorithm
+ * BasicChromosome - A candidate solution in our genetic algorithm
  * 
- * Each chromosome wraps a SudokuGrid and adds:
+ * Each chromosome wraps a grid and adds:
  * - Fitness calculation (how good is this solution?)
  * - Random initialization (fill empty cells while keeping sub-blocks valid)
  * - Comparison operators (so we can sort by fitness)
  * 
- * The key insight: we always keep sub-blocks valid (containing 1-9 exactly once),
+ * The key insight: we always keep sub-blocks valid (containing each digit exactly once),
  * so the fitness only needs to measure rows and columns.
+ *
+ * Chromosome is the 9x9 version; see BasicSudokuGrid for the Order parameter.
  */
-class Chromosome {
+template<int Order>
+class BasicChromosome {
 public:
+    using Grid = BasicSudokuGrid<Order>;
+
     // Empty chromosome - you'll need to set up the grid yourself
-    Chromosome();
+    BasicChromosome();
 
     // Create a chromosome from a puzzle. The fixed cells are preserved,
     // but empty cells aren't filled yet - call initialize_random() for that.
-    explicit Chromosome(const SudokuGrid& initial_puzzle);
+    explicit BasicChromosome(const Grid& initial_puzzle);
 
     // Copy constructor and assignment - makes a full copy
-    Chromosome(const Chromosome& other);
-    Chromosome& operator=(const Chromosome& other);
+    BasicChromosome(const BasicChromosome& other);
+    BasicChromosome& operator=(const BasicChromosome& other);
 
-    ~Chromosome() = default;
+    ~BasicChromosome() = default;
 
     // Get the underlying grid (const or non-const)
-    SudokuGrid& grid() { return grid_; }
-    const SudokuGrid& grid() const { return grid_; }
+    Grid& grid() { return grid_; }
+    const Grid& grid() const { return grid_; }
 
     // --- Fitness ---
     // Returns the fitness score. The result is cached so calling it
@@ -41,31 +46,42 @@ public:
     
     // Call this after you modify the grid to update the cached fitness
     void recalculate_fitness();
+
+    // Set the cached fitness directly when it's already known
+    // (e.g. when copying an individual out of a PopulationSoA)
+    void set_fitness(int fitness) { cached_fitness_ = fitness; }
     
     // Quick check: is this a perfect solution?
-    bool is_solution() const { return fitness() == SudokuGrid::MAX_SCORE; }
+    bool is_solution() const { return fitness() == Grid::MAX_SCORE; }
 
-    // Fill all empty cells randomly, but keep each 3x3 sub-block valid.
+    // Fill all empty cells randomly, but keep each sub-block valid.
     // This is how we create the initial population.
     void initialize_random();
 
     // Comparison by fitness (higher = better)
     // These let us use std::sort and similar algorithms.
-    bool operator<(const Chromosome& other) const { return fitness() < other.fitness(); }
-    bool operator>(const Chromosome& other) const { return fitness() > other.fitness(); }
-    bool operator==(const Chromosome& other) const { return fitness() == other.fitness(); }
-
-    // Print the grid and fitness score
-    friend std::ostream& operator<<(std::ostream& os, const Chromosome& chrom);
+    bool operator<(const BasicChromosome& other) const { return fitness() < other.fitness(); }
+    bool operator>(const BasicChromosome& other) const { return fitness() > other.fitness(); }
+    bool operator==(const BasicChromosome& other) const { return fitness() == other.fitness(); }
 
 private:
-    SudokuGrid grid_;
+    Grid grid_;
     int cached_fitness_;  // Stored fitness value (update with recalculate_fitness())
 
     // Fills one sub-block with the digits it's missing, in random order
     void fill_subblock_random(int subblock_index);
 };
 
-} // namespace sudoku_ga
+// Print the grid and fitness score
+template<int Order>
+std::ostream& operator<<(std::ostream& os, const BasicChromosome<Order>& chrom);
+
+// The classic 9x9 chromosome
+using Chromosome = BasicChromosome<3>;
 
+// Defined in Chromosome.cpp for these orders
+extern template class BasicChromosome<3>;
+extern template class BasicChromosome<4>;
+extern template class BasicChromosome<5>;
 
+} // namespace sudoku_ga
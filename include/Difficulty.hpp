@@ -0,0 +1,57 @@
+#pragma once
+
+#include "SudokuGrid.hpp"
+
+namespace sudoku_ga {
+
+// The hardest deduction the estimator needed
+enum class SolvingTechnique {
+    None,           // Nothing to do: the puzzle was already complete
+    NakedSingle,    // A cell with only one possible digit
+    HiddenSingle,   // A digit with only one possible cell in a row/column/sub-block
+    Search          // Singles weren't enough; some cells still need guessing
+};
+
+// Rough buckets used to pick a solving engine
+enum class DifficultyLevel {
+    Easy,       // Solved by naked singles alone
+    Medium,     // Solved once hidden singles are added
+    Hard,       // Singles leave less than half of the board open
+    Extreme     // Singles leave most of the board open (or the puzzle is invalid)
+};
+
+/*
+ * BasicDifficultyReport - What a quick look at a puzzle tells us
+ *
+ * propagated is the puzzle with every cell the singles could deduce filled
+ * in and marked fixed. Those values are certain, so any engine can start
+ * from it instead of the original puzzle and has fewer cells to search.
+ */
+template<int Order>
+struct BasicDifficultyReport {
+    int givens = 0;
+    int empty_after_propagation = 0;        // Cells the singles couldn't fill
+    int candidates_after_propagation = 0;   // Possible digits left in those cells
+    SolvingTechnique hardest_technique = SolvingTechnique::None;
+    bool contradiction = false;             // Some cell/digit had no place left
+    DifficultyLevel level = DifficultyLevel::Easy;
+    BasicSudokuGrid<Order> propagated;
+};
+
+/*
+ * Estimate how hard a puzzle is by running naked and hidden singles until
+ * nothing changes. This takes microseconds, so it's cheap enough to run in
+ * front of every solve.
+ *
+ * If the puzzle turns out to be contradictory, propagated is left equal to
+ * the original puzzle and the level is Extreme.
+ */
+template<int Order>
+BasicDifficultyReport<Order> estimate_difficulty(const BasicSudokuGrid<Order>& puzzle);
+
+const char* difficulty_level_name(DifficultyLevel level);
+const char* solving_technique_name(SolvingTechnique technique);
+
+using DifficultyReport = BasicDifficultyReport<3>;
+
+} // namespace sudoku_ga
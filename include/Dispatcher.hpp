@@ -0,0 +1,107 @@
+#pragma once
+
+#include "AnnealingSolver.hpp"
+#include "Difficulty.hpp"
+#include "Solver.hpp"
+#include "SudokuGrid.hpp"
+#include "TabuSolver.hpp"
+
+#include <functional>
+
+namespace sudoku_ga {
+
+// Ways the dispatcher can solve a puzzle
+enum class Engine {
+    Exact,      // Constraint propagation alone (no search)
+    Genetic,    // BasicSolver
+    Annealing,  // BasicAnnealingSolver
+    Tabu        // BasicTabuSolver
+};
+
+const char* engine_name(Engine engine);
+
+/*
+ * DispatchParams - Which engine and settings each difficulty level gets
+ *
+ * Easy and medium puzzles are finished by propagation, so they always use
+ * Exact. The settings here only matter for hard and extreme ones. Tuned
+ * parameter files (see sudoku_ga_tune) can be loaded into hard_params and
+ * extreme_params, one per difficulty bucket.
+ */
+struct DispatchParams {
+    Engine hard_engine = Engine::Genetic;
+    Engine extreme_engine = Engine::Tabu;
+
+    SolverParams hard_params;        // GA settings for hard puzzles
+    SolverParams extreme_params;     // GA settings for extreme ones (if extreme_engine is Genetic)
+    AnnealingParams annealing_params;
+    TabuParams tabu_params;
+
+    // Defaults: a small GA is enough when propagation has filled in most
+    // of the board; extreme puzzles get a bigger one from the start
+    DispatchParams() {
+        hard_params.population_size = 50;
+        hard_params.conflict_directed_mutation = true;
+        hard_params.adaptive_rates = true;
+
+        extreme_params.population_size = 300;
+        extreme_params.conflict_directed_mutation = true;
+        extreme_params.adaptive_rates = true;
+    }
+};
+
+/*
+ * Dispatcher - Send each puzzle to the cheapest engine that can handle it
+ *
+ * solve() runs estimate_difficulty() first (microseconds), then:
+ * - if propagation finished the puzzle, returns that straight away;
+ * - if propagation found a contradiction (no solution exists), returns
+ *   the puzzle unsolved straight away, without running any engine;
+ * - otherwise runs the engine chosen for the puzzle's level on the
+ *   propagated puzzle, so it only has to search the cells left open.
+ *
+ * Usage:
+ *   Dispatcher dispatcher;
+ *   SolverResult result = dispatcher.solve(puzzle);
+ */
+template<int Order>
+class BasicDispatcher {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Report = BasicDifficultyReport<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    explicit BasicDispatcher(const DispatchParams& params = DispatchParams{});
+
+    // Analyse, pick an engine and solve. result.elapsed_seconds includes
+    // the analysis.
+    Result solve(const Grid& puzzle);
+
+    // Same, for callers that already have the report
+    Result solve(const Report& report);
+
+    // The engine solve() would use for this report
+    Engine choose_engine(const Report& report) const;
+
+    const DispatchParams& params() const { return params_; }
+    DispatchParams& params() { return params_; }
+
+    // Passed on to whichever engine runs; see BasicSolver::set_stop_condition
+    void set_stop_condition(std::function<bool()> should_stop) { should_stop_ = std::move(should_stop); }
+
+private:
+    DispatchParams params_;
+    std::function<bool()> should_stop_;
+
+    // The propagated grid as a finished result (only valid if it's solved)
+    static Result exact_result(const Grid& propagated);
+};
+
+using Dispatcher = BasicDispatcher<3>;
+
+extern template class BasicDispatcher<3>;
+extern template class BasicDispatcher<4>;
+extern template class BasicDispatcher<5>;
+
+} // namespace sudoku_ga
@@ -5,6 +5,9 @@
 
 namespace sudoku_ga {
 
+// All operators work on any board size; they're defined in
+// GeneticOperations.cpp for the orders listed in SudokuGrid.hpp.
+
 /*
  * CROSSOVER
  * 
@@ -15,33 +18,150 @@ namespace sudoku_ga {
  * Child 2 gets the best "column stacks" (groups of 3 columns) from either parent.
  * 
  * "Best" means whichever parent has more unique digits in that region.
+ *
+ * crossover_into() writes the children straight into child1/child2 (e.g.
+ * slots of the next generation), copying each band or stack exactly once.
+ * The children must not alias the parents.
  */
-std::pair<Chromosome, Chromosome> crossover(const Chromosome& parent1, 
-                                             const Chromosome& parent2);
+template<int Order>
+void crossover_into(const BasicChromosome<Order>& parent1,
+                    const BasicChromosome<Order>& parent2,
+                    BasicChromosome<Order>& child1,
+                    BasicChromosome<Order>& child2);
+
+// Same as crossover_into(), returning the children by value
+template<int Order>
+std::pair<BasicChromosome<Order>, BasicChromosome<Order>> crossover(const BasicChromosome<Order>& parent1,
+                                                                    const BasicChromosome<Order>& parent2);
 
 /*
  * MUTATION
  * 
  * Randomly swaps two non-fixed cells within a sub-block.
- * This preserves the sub-block constraint (still has digits 1-9),
+ * This preserves the sub-block constraint (each digit still appears once),
  * but changes the row/column configuration.
  * 
  * The mutation_rate controls how likely each sub-block is to be mutated.
- * With rate=0.3, each of the 9 sub-blocks has a 30% chance.
+ * With rate=0.3, each sub-block has a 30% chance.
  */
-void mutate(Chromosome& chrom, double mutation_rate);
+template<int Order>
+void mutate(BasicChromosome<Order>& chrom, double mutation_rate);
 
-// Mutate just one specific sub-block (used by mutate() and local_search())
-void mutate_subblock(Chromosome& chrom, int subblock_index);
+// Mutate just one specific sub-block (used by mutate())
+template<int Order>
+void mutate_subblock(BasicChromosome<Order>& chrom, int subblock_index);
+
+/*
+ * SWAP MOVES
+ * 
+ * The building block of mutation and local search: exchange two cells of
+ * the same sub-block. apply_swap() returns the change in fitness by
+ * re-scoring only the (at most) two rows and two columns involved, which is
+ * much cheaper than recalculate_fitness(). swap_cells() exchanges the cells
+ * without scoring, e.g. to undo a rejected apply_swap().
+ */
+struct CellSwap {
+    int cell1;   // Flat cell indices (see BasicSudokuGrid::cell_index)
+    int cell2;
+};
+
+// Pick two random non-fixed cells of a sub-block (false if it has fewer than 2)
+template<int Order>
+bool random_subblock_swap(const BasicSudokuGrid<Order>& grid, int subblock_index, CellSwap& swap);
+
+template<int Order>
+void swap_cells(BasicSudokuGrid<Order>& grid, const CellSwap& swap);
+
+template<int Order>
+int apply_swap(BasicSudokuGrid<Order>& grid, const CellSwap& swap);
+
+/*
+ * CONFLICT-DIRECTED MUTATION
+ * 
+ * Near the end of a run most cells are already right, so swapping random
+ * cells mostly breaks things. ConflictTracker counts, for every digit, how
+ * often it appears in each row and column; a cell is "in conflict" when
+ * its digit also appears elsewhere in its row or column.
+ * 
+ * mutate_conflicts() works like mutate(), but in each chosen sub-block it
+ * swaps a conflicting cell (with another conflicting one when possible),
+ * and leaves conflict-free sub-blocks alone. The same counts say when a
+ * row or column gains or loses a distinct digit, so the new fitness comes
+ * from them instead of re-scoring the whole grid.
+ */
+template<int Order>
+class ConflictTracker {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Geometry = typename Grid::Geometry;
+
+    explicit ConflictTracker(const Grid& grid);
+
+    // How many other cells in this cell's row and column hold the same digit
+    int conflicts(const Grid& grid, int cell) const {
+        int digit = grid.get(cell);
+        return row_counts_[Geometry::row_of(cell)][digit] +
+               col_counts_[Geometry::col_of(cell)][digit] - 2;
+    }
+
+    // Swap two cells of the grid and keep the counts up to date
+    void apply(Grid& grid, const CellSwap& swap);
+
+    // How much the grid's fitness has changed through apply() so far
+    int score_change() const { return score_change_; }
+
+private:
+    // counts[i][d] = how many times digit d appears in row/column i
+    uint8_t row_counts_[Grid::SIZE][Grid::SIZE + 1] = {};
+    uint8_t col_counts_[Grid::SIZE][Grid::SIZE + 1] = {};
+    int score_change_ = 0;
+
+    void move_digit(int cell, int from, int to);
+};
+
+template<int Order>
+void mutate_conflicts(BasicChromosome<Order>& chrom, double mutation_rate);
 
 /*
  * LOCAL SEARCH (hill climbing)
  * 
- * A simple optimization: try a few random mutations and keep the best one.
+ * A simple optimization: try a few random swaps and keep the ones that help.
  * This helps the GA converge faster by exploiting good solutions.
  * 
- * num_candidates = how many variations to try (usually 2-3)
+ * Works in place: each swap is kept if it improves the fitness and undone
+ * otherwise. The chromosome's cached fitness must be up to date.
+ * 
+ * num_candidates = how many swaps to try (usually 2-3)
  */
-Chromosome local_search(const Chromosome& parent, int num_candidates);
+template<int Order>
+void local_search(BasicChromosome<Order>& chrom, int num_candidates);
+
+/*
+ * EXHAUSTIVE LOCAL SEARCH
+ * 
+ * Instead of sampling random swaps, look at every legal swap in a sub-block
+ * (at most 36 on 9x9) using delta evaluation, and apply either:
+ * - the first one that improves the fitness (first improvement), or
+ * - the one that improves it the most (steepest ascent).
+ * 
+ * This converges much faster than random sampling on nearly solved grids.
+ */
+enum class LocalSearchStrategy {
+    Random,            // local_search(chrom, num_candidates) above
+    FirstImprovement,
+    SteepestAscent,
+};
+
+// One improving move in subblock_index, or in the whole grid if it's < 0.
+// Returns false (and leaves the chromosome alone) if no swap improves it.
+template<int Order>
+bool improve_by_swap(BasicChromosome<Order>& chrom, int subblock_index, bool first_improvement);
+
+// num_steps rounds of the given strategy. Each round scans one random
+// sub-block, or the whole grid if whole_grid is set (stopping early at a
+// local optimum). Random falls back to the random-swap local_search.
+template<int Order>
+void local_search(BasicChromosome<Order>& chrom, LocalSearchStrategy strategy,
+                  int num_steps, bool whole_grid);
 
 } // namespace sudoku_ga
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace sudoku_ga {
+
+namespace geometry_detail {
+
+template<int Order>
+struct Tables {
+    static constexpr int SIZE = Order * Order;
+    static constexpr int NUM_CELLS = SIZE * SIZE;
+    static constexpr int NUM_PEERS = 2 * (SIZE - 1) + (Order - 1) * (Order - 1);
+
+    // Smallest type that holds a cell index (a byte up to 16x16)
+    using Cell = std::conditional_t<(NUM_CELLS <= 256), uint8_t, uint16_t>;
+    using Unit = std::array<Cell, SIZE>;
+    using Peers = std::array<Cell, NUM_PEERS>;
+
+    std::array<uint8_t, NUM_CELLS> row_of{};
+    std::array<uint8_t, NUM_CELLS> col_of{};
+    std::array<uint8_t, NUM_CELLS> box_of{};
+    std::array<Unit, SIZE> row_cells{};
+    std::array<Unit, SIZE> col_cells{};
+    std::array<Unit, SIZE> box_cells{};
+    std::array<Peers, NUM_CELLS> peers{};
+};
+
+template<int Order>
+constexpr Tables<Order> build_tables() {
+    using T = Tables<Order>;
+    using Cell = typename T::Cell;
+
+    T tables;
+    std::array<int, T::SIZE> box_filled{};
+    for (int cell = 0; cell < T::NUM_CELLS; ++cell) {
+        int row = cell / T::SIZE;
+        int col = cell % T::SIZE;
+        int box = (row / Order) * Order + col / Order;
+
+        tables.row_of[cell] = static_cast<uint8_t>(row);
+        tables.col_of[cell] = static_cast<uint8_t>(col);
+        tables.box_of[cell] = static_cast<uint8_t>(box);
+        tables.row_cells[row][col] = static_cast<Cell>(cell);
+        tables.col_cells[col][row] = static_cast<Cell>(cell);
+        tables.box_cells[box][box_filled[box]++] = static_cast<Cell>(cell);
+    }
+
+    // Peers row by row, so they come out in increasing order: the rest of
+    // the cell's own row, the sub-block's part of the other rows in its
+    // band, and just the cell's column everywhere else
+    for (int cell = 0; cell < T::NUM_CELLS; ++cell) {
+        int row = cell / T::SIZE;
+        int col = cell % T::SIZE;
+        int left = col / Order * Order;
+        int count = 0;
+        for (int r = 0; r < T::SIZE; ++r) {
+            if (r == row) {
+                for (int c = 0; c < T::SIZE; ++c) {
+                    if (c != col) {
+                        tables.peers[cell][count++] = static_cast<Cell>(r * T::SIZE + c);
+                    }
+                }
+            } else if (r / Order == row / Order) {
+                for (int c = left; c < left + Order; ++c) {
+                    tables.peers[cell][count++] = static_cast<Cell>(r * T::SIZE + c);
+                }
+            } else {
+                tables.peers[cell][count++] = static_cast<Cell>(r * T::SIZE + col);
+            }
+        }
+    }
+    return tables;
+}
+
+} // namespace geometry_detail
+
+/*
+ * BasicGridGeometry - Lookup tables for where every cell sits
+ *
+ * Cells are numbered 0 to NUM_CELLS - 1, left-to-right, top-to-bottom (the
+ * same flat index as BasicSudokuGrid::cell_index). Instead of working out
+ * rows, columns and sub-blocks with division and modulo every time, code
+ * can look them up here:
+ *
+ *   row_of(cell), col_of(cell), box_of(cell)     which units a cell is in
+ *   row_cells(row), col_cells(col), box_cells(box)   the SIZE cells of a unit
+ *   peers(cell)                                  every other cell sharing a
+ *                                                row, column or sub-block
+ *
+ * Cells within a unit, and a cell's peers, are listed in increasing order
+ * (so a sub-block is read row by row, the way the nested loops did). The
+ * tables are built by the compiler, so they cost nothing at runtime. On a
+ * 9x9 board each cell has 20 peers.
+ */
+template<int Order>
+struct BasicGridGeometry {
+    static constexpr int SIZE = Order * Order;
+    static constexpr int NUM_CELLS = SIZE * SIZE;
+    static constexpr int NUM_PEERS = geometry_detail::Tables<Order>::NUM_PEERS;
+
+    using Cell = typename geometry_detail::Tables<Order>::Cell;
+    using Unit = typename geometry_detail::Tables<Order>::Unit;
+    using Peers = typename geometry_detail::Tables<Order>::Peers;
+
+    static constexpr int row_of(int cell) { return tables_.row_of[cell]; }
+    static constexpr int col_of(int cell) { return tables_.col_of[cell]; }
+    static constexpr int box_of(int cell) { return tables_.box_of[cell]; }
+
+    static constexpr const Unit& row_cells(int row) { return tables_.row_cells[row]; }
+    static constexpr const Unit& col_cells(int col) { return tables_.col_cells[col]; }
+    static constexpr const Unit& box_cells(int box) { return tables_.box_cells[box]; }
+
+    static constexpr const Peers& peers(int cell) { return tables_.peers[cell]; }
+
+private:
+    static constexpr geometry_detail::Tables<Order> tables_ = geometry_detail::build_tables<Order>();
+};
+
+// The classic 9x9 board
+using GridGeometry = BasicGridGeometry<3>;
+
+} // namespace sudoku_ga
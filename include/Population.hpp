@@ -17,47 +17,59 @@ namespace sudoku_ga {
  * 3. Replace the old population with the new one
  * 
  * This class handles storage and selection of chromosomes.
+ * Population is the 9x9 version; see BasicSudokuGrid for the Order parameter.
  */
-class Population {
+template<int Order>
+class BasicPopulation {
 public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+
     // Empty population (you'll add individuals later)
-    Population();
+    BasicPopulation();
 
     // Create a population of the given size, all starting from the same puzzle
     // but with different random initializations
-    Population(const SudokuGrid& puzzle, int size);
+    BasicPopulation(const Grid& puzzle, int size);
 
-    // Access individuals by index (like an array)
-    Chromosome& operator[](size_t index) { return individuals_[index]; }
+    // Access individuals by index (like an array). Read-only: the statistics
+    // below are cached, so individuals only change through replace_generation()
+    // or swap_generation().
     const Chromosome& operator[](size_t index) const { return individuals_[index]; }
 
     size_t size() const { return individuals_.size(); }
     bool empty() const { return individuals_.empty(); }
 
-    // These let you use range-based for loops: for (auto& chrom : population)
-    auto begin() { return individuals_.begin(); }
-    auto end() { return individuals_.end(); }
-    auto begin() const { return individuals_.begin(); }
-    auto end() const { return individuals_.end(); }
+    // These let you use range-based for loops: for (const auto& chrom : population)
+    auto begin() const { return individuals_.cbegin(); }
+    auto end() const { return individuals_.cend(); }
 
     // Find the chromosome with the highest/lowest fitness
     const Chromosome& get_best() const;
-    Chromosome& get_best();
     const Chromosome& get_worst() const;
 
     // --- Selection ---
     // Tournament selection: pick a few random individuals, return the best one.
     // This is how we choose parents - fitter individuals are more likely to win.
-    Chromosome& tournament_select(int tournament_size);
+    const Chromosome& tournament_select(int tournament_size) const;
 
     // Select two different parents for crossover
-    std::pair<Chromosome*, Chromosome*> select_parents(int tournament_size);
+    std::pair<const Chromosome*, const Chromosome*> select_parents(int tournament_size) const;
 
     // --- Generation management ---
     // Replace all individuals with a new set (used at the end of each generation)
     void replace_generation(std::vector<Chromosome> new_generation);
 
+    // Same, but hands the old individuals back in new_generation so the
+    // caller can reuse their storage for the next generation
+    void swap_generation(std::vector<Chromosome>& new_generation);
+
+    // Recompute the cached statistics below in a single pass.
+    // Called automatically by the constructor and both of the above.
+    void update_statistics();
+
     // --- Statistics ---
+    // All of these are read from the cache, so they're O(1).
     int best_fitness() const;
     int worst_fitness() const;
     double average_fitness() const;
@@ -68,6 +80,20 @@ public:
 
 private:
     std::vector<Chromosome> individuals_;
+
+    // Cached statistics (see update_statistics())
+    size_t best_index_ = 0;
+    size_t worst_index_ = 0;
+    long long fitness_sum_ = 0;
+    bool has_solution_ = false;
 };
 
+// The classic 9x9 population
+using Population = BasicPopulation<3>;
+
+// Defined in Population.cpp for these orders
+extern template class BasicPopulation<3>;
+extern template class BasicPopulation<4>;
+extern template class BasicPopulation<5>;
+
 } // namespace sudoku_ga
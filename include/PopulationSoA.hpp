@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Chromosome.hpp"
+#include "Population.hpp"
+#include "SudokuGrid.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace sudoku_ga {
+
+template<int Order>
+class BasicPopulationSoA;
+
+/*
+ * BasicChromosomeView - A lightweight handle to one individual in a PopulationSoA
+ *
+ * It looks like a Chromosome (get/set cells, fitness, recalculate_fitness)
+ * but doesn't own anything: the digits live in the population's cell planes
+ * and the fitness lives in its dense fitness array.
+ *
+ * Views are cheap to copy. They stay valid until the population is resized.
+ */
+template<int Order>
+class BasicChromosomeView {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using PopulationSoA = BasicPopulationSoA<Order>;
+
+    BasicChromosomeView(PopulationSoA& population, size_t index)
+        : population_(&population), index_(index) {}
+
+    size_t index() const { return index_; }
+
+    int get(int row, int col) const;
+    void set(int row, int col, int value);
+    bool is_fixed(int row, int col) const;
+
+    int fitness() const;
+    void set_fitness(int fitness);
+    void recalculate_fitness();
+    bool is_solution() const { return fitness() == Grid::MAX_SCORE; }
+
+    // Move an individual between the SoA layout and a regular Chromosome.
+    // The genetic operators only work on Chromosomes, so this is how they
+    // get at an individual.
+    void load_from(const Chromosome& chrom);
+    void store_to(Chromosome& chrom) const;
+
+private:
+    PopulationSoA* population_;
+    size_t index_;
+};
+
+/*
+ * BasicPopulationSoA - A population stored as "struct of arrays"
+ *
+ * Population keeps a std::vector<Chromosome>, so every individual carries a
+ * full SudokuGrid and its fitness side by side. Here instead:
+ *
+ * - Digits are stored in byte planes, one per cell (81 for 9x9). Plane k holds cell k
+ *   of every individual, one byte each, so the same cell of many individuals
+ *   sits in consecutive bytes (good for evaluating many grids at once).
+ * - Fitness values sit in their own dense array, so selection only touches
+ *   those few hundred bytes and never drags grids through the cache.
+ * - Fixed cells are identical for every individual, so we keep the puzzle
+ *   once instead of one copy per individual.
+ *
+ * What it's good for is scoring and selection: evaluate_all() scores a
+ * whole population straight from the planes with score_batch(), and
+ * tournaments read nothing but the fitness array. It is a standalone
+ * layout, not something Solver breeds in. The crossover/mutation/local
+ * search operators need each child's exact fitness as they go, and one
+ * individual's cells are stride bytes apart, so breeding here would mean
+ * unpacking every parent into a Chromosome and packing every child back -
+ * more copying than the regular Population, with no batch scoring to
+ * make up for it.
+ *
+ * PopulationSoA is the 9x9 version; see BasicSudokuGrid for Order.
+ */
+template<int Order>
+class BasicPopulationSoA {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Population = BasicPopulation<Order>;
+    using ChromosomeView = BasicChromosomeView<Order>;
+
+    static constexpr int NUM_CELLS = Grid::NUM_CELLS;
+
+    // Planes are padded to a multiple of this many individuals, so vector
+    // code can always process full lanes
+    static constexpr size_t LANE_PADDING = 32;
+
+    // Empty population
+    BasicPopulationSoA();
+
+    // Random population of the given size, same as Population(puzzle, size)
+    BasicPopulationSoA(const Grid& puzzle, int size);
+
+    // An empty (all zeros) population of the given size for the same puzzle.
+    // Used to hold the next generation while it's being built.
+    static BasicPopulationSoA with_size(const Grid& puzzle, size_t size);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Distance in bytes between one cell's entries in consecutive planes
+    size_t stride() const { return stride_; }
+
+    ChromosomeView operator[](size_t index) { return ChromosomeView(*this, index); }
+
+    // --- Raw storage (for batch kernels) ---
+    // cell_plane(k)[i] is cell k (row-major, 0..NUM_CELLS-1) of individual i
+    uint8_t* cell_plane(int cell) { return cells_.data() + cell * stride_; }
+    const uint8_t* cell_plane(int cell) const { return cells_.data() + cell * stride_; }
+
+    int* fitness_data() { return fitness_.data(); }
+    const int* fitness_data() const { return fitness_.data(); }
+
+    const Grid& puzzle() const { return puzzle_; }
+
+    // --- Conversion ---
+    void load_from(const Population& population);
+    Chromosome to_chromosome(size_t index) const;
+    void store_individual(size_t index, Chromosome& chrom) const;
+
+    // Copy one individual (digits and fitness) from another population
+    void copy_individual(size_t dest, const BasicPopulationSoA& source, size_t src);
+
+    // Recalculate the fitness of every individual
+    void evaluate_all();
+
+    // --- Selection ---
+    // Same as Population::tournament_select, but only reads the fitness array
+    size_t tournament_select(int tournament_size) const;
+    std::pair<size_t, size_t> select_parents(int tournament_size) const;
+
+    // --- Statistics (cached, see Population::update_statistics) ---
+    void update_statistics();
+    size_t best_index() const { return best_index_; }
+    int best_fitness() const;
+    int worst_fitness() const;
+    double average_fitness() const;
+    bool has_solution() const { return has_solution_; }
+
+private:
+    Grid puzzle_;                // Givens and fixed flags, shared by everyone
+    size_t size_ = 0;            // Number of individuals
+    size_t stride_ = 0;          // size_ rounded up to LANE_PADDING
+    std::vector<uint8_t> cells_; // NUM_CELLS planes of stride_ bytes
+    std::vector<int> fitness_;   // One entry per individual
+
+    size_t best_index_ = 0;
+    size_t worst_index_ = 0;
+    long long fitness_sum_ = 0;
+    bool has_solution_ = false;
+
+    friend class BasicChromosomeView<Order>;
+};
+
+// The classic 9x9 versions
+using ChromosomeView = BasicChromosomeView<3>;
+using PopulationSoA = BasicPopulationSoA<3>;
+
+// --- ChromosomeView inline accessors ---
+
+template<int Order>
+inline int BasicChromosomeView<Order>::get(int row, int col) const {
+    return population_->cell_plane(row * Grid::SIZE + col)[index_];
+}
+
+template<int Order>
+inline void BasicChromosomeView<Order>::set(int row, int col, int value) {
+    population_->cell_plane(row * Grid::SIZE + col)[index_] = static_cast<uint8_t>(value);
+}
+
+template<int Order>
+inline bool BasicChromosomeView<Order>::is_fixed(int row, int col) const {
+    return population_->puzzle_.is_fixed(row, col);
+}
+
+template<int Order>
+inline int BasicChromosomeView<Order>::fitness() const {
+    return population_->fitness_[index_];
+}
+
+template<int Order>
+inline void BasicChromosomeView<Order>::set_fitness(int fitness) {
+    population_->fitness_[index_] = fitness;
+}
+
+// Defined in PopulationSoA.cpp for these orders
+extern template class BasicChromosomeView<3>;
+extern template class BasicChromosomeView<4>;
+extern template class BasicChromosomeView<5>;
+extern template class BasicPopulationSoA<3>;
+extern template class BasicPopulationSoA<4>;
+extern template class BasicPopulationSoA<5>;
+
+} // namespace sudoku_ga
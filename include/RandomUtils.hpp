@@ -1,7 +1,11 @@
 #pragma once
 
+#include "ScratchArena.hpp"
+
 #include <algorithm>
 #include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 
 namespace sudoku_ga {
@@ -9,17 +13,20 @@ namespace sudoku_ga {
 /*
  * RandomGenerator - A simple wrapper around C++'s random number facilities
  * 
- * This is a "singleton" - there's only one instance shared across the program.
- * Access it with RandomGenerator::instance() or the shortcut rng().
+ * This is a "singleton" - there's one instance per thread, shared by all
+ * the code running on that thread. Access it with RandomGenerator::instance()
+ * or the shortcut rng().
  * 
  * Why a singleton? We want all random operations to use the same generator
- * so results are reproducible if we set a seed.
+ * so results are reproducible if we set a seed. Why one per thread? So
+ * solves running on different threads never share (and race on) a
+ * generator. Seeding only affects the calling thread's generator.
  */
 class RandomGenerator {
 public:
-    // Get the single shared instance
+    // Get this thread's instance
     static RandomGenerator& instance() {
-        static RandomGenerator rng;
+        static thread_local RandomGenerator rng;
         return rng;
     }
 
@@ -28,6 +35,31 @@ public:
         engine_.seed(s);
     }
 
+    // The generator's exact internal state, and a way to put it back.
+    // Used by checkpoints so a resumed run draws the same numbers.
+    std::string state() const {
+        std::ostringstream out;
+        out << engine_;
+        return out.str();
+    }
+
+    // Returns false, and leaves the generator as it was, if the text
+    // isn't a saved state
+    bool set_state(const std::string& state) {
+        std::mt19937 engine;
+        if (!parse_state(state, engine)) {
+            return false;
+        }
+        engine_ = engine;
+        return true;
+    }
+
+    // Whether set_state() would accept this text
+    static bool valid_state(const std::string& state) {
+        std::mt19937 engine;
+        return parse_state(state, engine);
+    }
+
     // Random integer between min and max (inclusive on both ends)
     int rand_int(int min, int max) {
         std::uniform_int_distribution<int> dist(min, max);
@@ -40,9 +72,9 @@ public:
         return dist(engine_);
     }
 
-    // Randomly reorder a vector
-    template<typename T>
-    void shuffle(std::vector<T>& vec) {
+    // Randomly reorder a vector (a std::vector or a std::pmr::vector)
+    template<typename Vector>
+    void shuffle(Vector& vec) {
         std::shuffle(vec.begin(), vec.end(), engine_);
     }
 
@@ -56,9 +88,9 @@ public:
     }
 
     // Pick k different random indices from 0 to n-1
-    // Used for tournament selection
-    std::vector<int> sample_indices(int n, int k) {
-        std::vector<int> indices(n);
+    // Used for tournament selection (the list comes from the scratch arena)
+    std::pmr::vector<int> sample_indices(int n, int k) {
+        std::pmr::vector<int> indices(n, scratch_memory());
         for (int i = 0; i < n; ++i) indices[i] = i;
         shuffle(indices);
         indices.resize(k);
@@ -69,15 +101,24 @@ private:
     // Private constructor - use instance() instead
     RandomGenerator() : engine_(std::random_device{}()) {}
     
-    // Prevent copying (there should only be one instance)
+    // Prevent copying (there should only be one instance per thread)
     RandomGenerator(const RandomGenerator&) = delete;
     RandomGenerator& operator=(const RandomGenerator&) = delete;
 
     // Mersenne Twister - a high-quality random number generator
     std::mt19937 engine_;
+
+    // The whole text has to be one engine state, nothing more
+    static bool parse_state(const std::string& state, std::mt19937& engine) {
+        std::istringstream in(state);
+        if (!(in >> engine)) {
+            return false;
+        }
+        return in.eof() || (in >> std::ws).eof();
+    }
 };
 
-// Shortcut to get the global random generator
+// Shortcut to get this thread's random generator
 inline RandomGenerator& rng() {
     return RandomGenerator::instance();
 }
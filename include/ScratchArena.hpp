@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace sudoku_ga {
+
+/*
+ * ScratchArena - Fast memory for short-lived working lists
+ *
+ * The GA keeps making small temporary lists: the candidates of every
+ * tournament, the free cells of a sub-block for every mutation, the missing
+ * digits when filling a sub-block. Getting each of them from the general
+ * allocator (malloc) costs time, and with many threads solving at once
+ * they all compete for it.
+ *
+ * So each thread has its own arena instead (like it has its own rng()).
+ * Allocating just moves a pointer along a buffer
+ * (a std::pmr::monotonic_buffer_resource), freeing does nothing, and there's
+ * no locking because only its own thread uses it. Everything is handed
+ * back in one go when the outermost ArenaScope on the thread ends. The
+ * solver opens one around each pair of children it breeds (selection,
+ * crossover, mutation, local search), so the same few KB are reused - and
+ * stay in cache - for every pair, and one around building the first
+ * generation. The buffer itself is kept, and grows to fit the biggest
+ * scope seen, so after the first few pairs there are no mallocs at all.
+ *
+ * Containers opt in by being std::pmr containers built with
+ * scratch_memory(). Outside any ArenaScope that's plain new/delete, so
+ * code that doesn't know about scopes is always safe. Inside one, nothing
+ * from the arena may outlive the scope - copy into a normal container to
+ * keep something.
+ */
+class ScratchArena {
+public:
+    // Get this thread's arena
+    static ScratchArena& instance();
+
+    // Where scratch memory comes from right now: the arena inside an
+    // ArenaScope, new/delete outside
+    std::pmr::memory_resource* resource() {
+        return scopes_ > 0 ? &arena_ : std::pmr::new_delete_resource();
+    }
+
+private:
+    friend class ArenaScope;
+
+    // Counts what the arena needs beyond its buffer, to size the next one
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    ScratchArena();
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Give everything back (when the last scope closes)
+    void release();
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t buffer_size_;
+    Overflow overflow_;
+    std::pmr::monotonic_buffer_resource arena_;
+    int scopes_ = 0;     // ArenaScopes open on this thread
+};
+
+// Shortcut to this thread's scratch memory, for pmr containers
+inline std::pmr::memory_resource* scratch_memory() {
+    return ScratchArena::instance().resource();
+}
+
+/*
+ * ArenaScope - Use the arena until the outermost scope ends
+ *
+ *   {
+ *       ArenaScope arena;
+ *       ... select two parents and breed two children ...
+ *   }   // all scratch memory handed back here
+ */
+class ArenaScope {
+public:
+    ArenaScope() { ++ScratchArena::instance().scopes_; }
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+} // namespace sudoku_ga
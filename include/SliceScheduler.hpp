@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Affinity.hpp"
+#include "Solver.hpp"
+#include "SolverPool.hpp"
+#include "SudokuGrid.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * SchedulerParams - Sizing for BasicSliceScheduler
+ */
+struct SchedulerParams {
+    int workers = 0;                  // Threads (0 = one per core)
+    size_t max_active = 256;          // Solves in progress at once
+    size_t max_queued = 4096;         // Requests waiting to start
+    int slice_generations = 50;       // Generations per turn
+    AffinityPolicy affinity = AffinityPolicy::None;  // Worker pinning (see Affinity.hpp)
+};
+
+/*
+ * BasicSliceScheduler - Many solves taking turns on a few threads
+ *
+ * SolverPool gives each request a thread until it's done, so a few hard
+ * puzzles can hold up everything behind them. This scheduler runs up to
+ * max_active solves at once on a small fixed set of threads instead: each
+ * turn, a thread picks one solve, advances it slice_generations
+ * generations (BasicSolver::step), and puts it back. Short puzzles finish
+ * after a turn or two while hard ones keep making progress, and memory
+ * stays bounded by max_active populations.
+ *
+ * Which solve goes next? Higher priority always wins. Among equal
+ * priorities the one with the highest urgency, which adds up:
+ *   - how close its deadline is:    1 / (1 + seconds left)
+ *   - how close it is to solved:    1 / (1 + conflicts left)
+ *   - how long it has waited:       turns since its last one / active solves
+ * Each part is at most about 1 at first, but the waiting part keeps
+ * growing, so nothing starves. New solves count as having waited a full
+ * round, to get their first turn quickly.
+ *
+ * Requests beyond max_active wait in a queue (ordered like SolverPool's),
+ * which holds at most max_queued of them (cancelled ones don't count):
+ * submit() blocks when it's full and try_submit() returns nothing.
+ * Handles, deadlines and cancellation work as in SolverPool. A request
+ * whose deadline passes while it waits, in the queue or between turns,
+ * is completed at the deadline by a small expiry thread, even if every
+ * worker is busy. If a solve throws, its handle's get() rethrows.
+ *
+ * Usage:
+ *   SliceScheduler scheduler;
+ *   auto handle = scheduler.submit(puzzle, SolveOptions::within(std::chrono::seconds(5)));
+ *   SolverResult result = handle.get();
+ */
+template<int Order>
+class BasicSliceScheduler {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Result = BasicSolverResult<Order>;
+    using Handle = BasicSolveHandle<Order>;
+
+    explicit BasicSliceScheduler(const SolverParams& params = SolverParams{},
+                                 const SchedulerParams& scheduling = SchedulerParams{});
+    ~BasicSliceScheduler();
+
+    BasicSliceScheduler(const BasicSliceScheduler&) = delete;
+    BasicSliceScheduler& operator=(const BasicSliceScheduler&) = delete;
+
+    // Queue a puzzle, waiting for room if the queue is full.
+    // Throws std::runtime_error after shutdown().
+    Handle submit(const Grid& puzzle, const SolveOptions& options = SolveOptions{});
+
+    // Queue a puzzle only if there's room right now
+    std::optional<Handle> try_submit(const Grid& puzzle, const SolveOptions& options = SolveOptions{});
+
+    // Stop everything; solves in progress complete as stopped with their
+    // best attempt so far
+    void shutdown();
+
+    size_t queued() const;
+    size_t active() const;
+    size_t worker_count() const { return workers_.size(); }
+
+private:
+    using Task = BasicSolveTask<Order>;
+    using TaskPtr = std::shared_ptr<Task>;
+
+    struct LaterFirst {
+        bool operator()(const TaskPtr& a, const TaskPtr& b) const { return a->runs_after(*b); }
+    };
+
+    // A request that has been let in
+    struct Active {
+        TaskPtr task;
+        BasicSolveRun<Order> run;
+        bool started = false;         // Has had its first turn
+        bool running = false;         // A thread is stepping it right now
+        uint64_t last_turn = 0;       // turn_count_ when its last turn ended
+    };
+
+    SolverParams params_;
+    SchedulerParams scheduling_;
+
+    std::shared_ptr<SolveQueueSignal> signal_;   // The lock, and room in the queue
+    std::condition_variable work_ready_;
+    std::condition_variable expiry_ready_;
+    std::vector<TaskPtr> waiting_;               // A heap ordered by LaterFirst
+    std::vector<std::unique_ptr<Active>> active_;
+    SolveOptions::Clock::time_point next_expiry_ = SolveOptions::Clock::time_point::max();
+    uint64_t next_sequence_ = 0;
+    uint64_t turn_count_ = 0;
+    std::atomic<bool> shutting_down_{false};
+
+    std::vector<std::thread> workers_;
+    std::thread expiry_thread_;
+
+    Handle enqueue(const Grid& puzzle, const SolveOptions& options, std::unique_lock<std::mutex>& lock);
+    bool has_room();
+    void remove_dead_tasks();
+    void worker_loop(size_t index);
+    void expiry_loop();
+
+    // Move waiting requests into active_ while there's room (mutex_ held)
+    void admit();
+
+    // The idle active solve to run next, or null (mutex_ held)
+    Active* pick();
+    double urgency(const Active& active, SolveOptions::Clock::time_point now) const;
+
+    void remove(Active* active);
+};
+
+using SliceScheduler = BasicSliceScheduler<3>;
+
+extern template class BasicSliceScheduler<3>;
+extern template class BasicSliceScheduler<4>;
+extern template class BasicSliceScheduler<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Canonical.hpp"
+#include "Chromosome.hpp"
+#include "Solver.hpp"
+#include "SudokuGrid.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace sudoku_ga {
+
+/*
+ * BasicSolutionCache - Remember solved puzzles, up to symmetry
+ *
+ * Puzzles are stored under their canonical form (see canonical_transform),
+ * so a puzzle that is a rotated, relabeled or shuffled copy of one solved
+ * before is a hit too. The stored solution is mapped back to the new
+ * puzzle's orientation, and checked against it before it's returned.
+ *
+ * Usage - put it in front of any engine with a solve(puzzle) method:
+ *   SolutionCache cache;
+ *   Solver solver;
+ *   SolverResult result = cache.solve(puzzle, solver);
+ *
+ * Only solved results are stored. Once max_entries is reached new
+ * solutions are no longer added (the cache keeps what it has). Puzzles
+ * with fewer than MIN_GIVENS givens skip the cache: they are (almost
+ * certainly) not proper puzzles, and canonicalizing near-empty grids is
+ * slow.
+ */
+template<int Order>
+class BasicSolutionCache {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    // The fewest givens a cacheable puzzle must have. On 9x9 it's 17, the
+    // proven minimum for a unique solution. No minimum is known for larger
+    // boards, so they get the same share of the board (17 of 81 cells):
+    // 53 on 16x16 and 131 on 25x25.
+    static constexpr int MIN_GIVENS = Order == 3 ? 17 : Grid::NUM_CELLS * 17 / 81;
+
+    // What lookup() worked out about a puzzle. Canonicalizing is the
+    // expensive part of a lookup, so store() after a miss reuses it.
+    struct Lookup {
+        bool cacheable = false;
+        BasicGridTransform<Order> transform;
+        std::string key;              // Canonical puzzle string
+    };
+
+    explicit BasicSolutionCache(size_t max_entries = 100000);
+
+    // Look up a solution for the puzzle; false on a miss
+    bool lookup(const Grid& puzzle, Grid& solution) const;
+    bool lookup(const Grid& puzzle, Grid& solution, Lookup& probe) const;
+
+    // Remember a solution (ignored if it doesn't solve the puzzle). The
+    // second form takes the Lookup from an earlier lookup() of the puzzle.
+    void store(const Grid& puzzle, const Grid& solution);
+    void store(const Lookup& probe, const Grid& puzzle, const Grid& solution);
+
+    // Cached result if there is one, otherwise engine.solve(puzzle),
+    // storing the answer if it was solved
+    template<typename Engine>
+    Result solve(const Grid& puzzle, Engine& engine);
+
+    size_t size() const { return entries_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    void clear();
+
+    // Does the puzzle have enough givens to be cached (see MIN_GIVENS)?
+    static bool cacheable(const Grid& puzzle);
+
+private:
+    size_t max_entries_;
+
+    // Canonical puzzle string -> canonical solution string
+    std::unordered_map<std::string, std::string> entries_;
+
+    mutable size_t hits_ = 0;
+    mutable size_t misses_ = 0;
+};
+
+/*
+ * The cache-in-front-of-an-engine logic, shared by the in-memory cache and
+ * BasicSolutionStore: a cached answer if there is one, otherwise
+ * engine.solve(puzzle), remembered if it was solved. The puzzle is only
+ * canonicalized once: the miss's Cache::Lookup goes on to store().
+ */
+template<int Order, typename Cache, typename Engine>
+BasicSolverResult<Order> solve_with_cache(Cache& cache, const BasicSudokuGrid<Order>& puzzle,
+                                          Engine& engine) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    BasicSudokuGrid<Order> solution;
+    typename Cache::Lookup probe;
+    if (cache.lookup(puzzle, solution, probe)) {
+        BasicSolverResult<Order> result;
+        result.solved = true;
+        result.best_individual = BasicChromosome<Order>(solution);
+        result.best_individual.recalculate_fitness();
+        result.best_fitness = result.best_individual.fitness();
+
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+        return result;
+    }
+
+    BasicSolverResult<Order> result = engine.solve(puzzle);
+    if (result.solved) {
+        cache.store(probe, puzzle, result.best_individual.grid());
+    }
+    return result;
+}
+
+template<int Order>
+template<typename Engine>
+BasicSolverResult<Order> BasicSolutionCache<Order>::solve(const Grid& puzzle, Engine& engine) {
+    return solve_with_cache(*this, puzzle, engine);
+}
+
+using SolutionCache = BasicSolutionCache<3>;
+
+extern template class BasicSolutionCache<3>;
+extern template class BasicSolutionCache<4>;
+extern template class BasicSolutionCache<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Solver.hpp"
+#include "SolutionCache.hpp"
+#include "SudokuGrid.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * BasicSolutionStore - A solution cache that survives restarts
+ *
+ * Like BasicSolutionCache (same canonical keys, so symmetric copies of a
+ * puzzle hit too), but kept in two files:
+ *
+ *   <path>.dat  The records: each is a packed canonical puzzle followed by
+ *               its packed canonical solution (4 bits per cell on 9x9,
+ *               5 bits on the larger boards). Only ever appended to.
+ *   <path>.idx  An open-addressing hash table (linear probing) from key
+ *               hash to record number, used through mmap so a lookup only
+ *               touches the slots it probes plus one record read.
+ *
+ * The index can always be rebuilt from the data file. That happens when
+ * it's missing, doesn't match the data file (e.g. after a crash between
+ * the two writes), or gets more than half full. A torn record at the end
+ * of the data file is cut off when the store is opened.
+ *
+ * Hits are checked twice before they're returned: the stored key must
+ * equal the puzzle's key (not just its hash), and the mapped solution must
+ * actually solve the puzzle.
+ *
+ * Not safe to share between processes writing at the same time.
+ *
+ * Usage:
+ *   SolutionStore store("solutions");   // solutions.dat / solutions.idx
+ *   Solver solver;
+ *   SolverResult result = store.solve(puzzle, solver);
+ */
+template<int Order>
+class BasicSolutionStore {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    // Open or create the store; throws std::runtime_error on I/O errors
+    // or if the files belong to a different board size
+    explicit BasicSolutionStore(const std::string& path);
+    ~BasicSolutionStore();
+
+    BasicSolutionStore(const BasicSolutionStore&) = delete;
+    BasicSolutionStore& operator=(const BasicSolutionStore&) = delete;
+
+    // What lookup() worked out about a puzzle, so store() after a miss
+    // doesn't canonicalize it again (as in BasicSolutionCache)
+    struct Lookup {
+        bool cacheable = false;
+        BasicGridTransform<Order> transform;
+        std::vector<uint8_t> key;     // Packed canonical puzzle
+        uint64_t hash = 0;            // Of key
+    };
+
+    // Look up a solution for the puzzle; false on a miss
+    bool lookup(const Grid& puzzle, Grid& solution);
+    bool lookup(const Grid& puzzle, Grid& solution, Lookup& probe);
+
+    // Append a solution (ignored if it doesn't solve the puzzle or the
+    // puzzle is already stored). The second form takes the Lookup from an
+    // earlier lookup() of the puzzle.
+    void store(const Grid& puzzle, const Grid& solution);
+    void store(const Lookup& probe, const Grid& puzzle, const Grid& solution);
+
+    // Stored result if there is one, otherwise engine.solve(puzzle)
+    template<typename Engine>
+    Result solve(const Grid& puzzle, Engine& engine) {
+        return solve_with_cache(*this, puzzle, engine);
+    }
+
+    // Write the index and data to disk now (otherwise the OS decides when).
+    // Throws std::runtime_error if either can't be synced.
+    void flush();
+
+    size_t size() const { return record_count_; }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    using Key = std::vector<uint8_t>;
+
+    std::string data_path_;
+    std::string index_path_;
+    int data_fd_ = -1;
+    int index_fd_ = -1;
+
+    // The mapped index file: a header followed by the slots
+    void* index_map_ = nullptr;
+    size_t index_bytes_ = 0;
+
+    uint64_t record_count_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+
+    void open_data();
+    void open_index();
+    void map_index(size_t capacity, bool create);
+    void unmap_index();
+
+    // Make a fresh index of the given capacity from the data file
+    void rebuild_index(size_t capacity);
+
+    // Slot where the key is, or the empty slot where it would go
+    size_t find_slot(uint64_t hash, const Key& key, bool& found) const;
+    void insert_slot(uint64_t hash, uint64_t record);
+
+    Key read_key(uint64_t record) const;
+    std::vector<uint8_t> read_record(uint64_t record) const;
+
+    // Fill in probe for the puzzle (the canonicalizing part of a lookup)
+    void prepare(const Grid& puzzle, Lookup& probe) const;
+};
+
+using SolutionStore = BasicSolutionStore<3>;
+
+extern template class BasicSolutionStore<3>;
+extern template class BasicSolutionStore<4>;
+extern template class BasicSolutionStore<5>;
+
+} // namespace sudoku_ga
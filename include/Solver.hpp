@@ -1,8 +1,15 @@
 #pragma once
 
+#include "AdaptiveRates.hpp"
+#include "Checkpoint.hpp"
+#include "GeneticOperations.hpp"
 #include "Population.hpp"
 #include "SudokuGrid.hpp"
 
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace sudoku_ga {
 
 /*
@@ -16,22 +23,85 @@ struct SolverParams {
     int max_generations = 100000;     // Give up after this many generations
     double crossover_rate = 0.3;      // Probability of combining two parents (30%)
     double mutation_rate = 0.3;       // Probability of mutating each sub-block (30%)
+    bool conflict_directed_mutation = false;  // Swap cells in row/column conflicts instead of random ones
     int tournament_size = 3;          // How many candidates compete in selection
-    int local_search_candidates = 2;  // How many mutations to try in local search
+    int local_search_candidates = 2;  // How many mutations (or exhaustive steps) to try in local search
     bool use_local_search = true;     // Enable the hill-climbing optimization
+    LocalSearchStrategy local_search_strategy = LocalSearchStrategy::Random;  // How swaps are chosen
+    bool local_search_whole_grid = false;  // Exhaustive strategies: scan all sub-blocks, not one
+    bool local_search_elite_only = false;  // Only improve the elite (needs elitism), not every child
     bool elitism = true;              // Always keep the best solution
     int report_interval = 1000;       // Print progress every N generations (0 = quiet)
+    bool adaptive_rates = false;      // Adjust the three rates above online (see AdaptiveRates)
+    std::string checkpoint_path;      // Where to save checkpoints (see BasicSolver::resume)
+    int checkpoint_interval = 0;      // Save a checkpoint every N generations (0 = never)
+    bool parallel_generation = false; // Breed each generation on all cores (WorkStealingPool);
+                                      // runs are then no longer reproducible from a seed
 };
 
 /*
  * SolverResult - What you get back after solving (or trying to solve)
  */
-struct SolverResult {
+template<int Order>
+struct BasicSolverResult {
     bool solved = false;              // Did we find a perfect solution?
     int generations = 0;              // How many generations did it take?
     int best_fitness = 0;             // Best fitness we achieved
-    Chromosome best_individual;       // The best solution (or attempt)
+    BasicChromosome<Order> best_individual;  // The best solution (or attempt)
     double elapsed_seconds = 0.0;     // How long did it take?
+    bool stopped = false;             // Gave up early because the stop condition said so
+};
+
+template<int Order> class BasicSolver;
+
+/*
+ * BasicSolveRun - A solve in progress, advanced a few generations at a time
+ *
+ * BasicSolver::start() makes one and BasicSolver::step() advances it. The
+ * run holds everything that belongs to one solve (population, rates,
+ * generation count). That means one solver can take turns on many runs,
+ * and a run can be stepped by a different solver (or thread) each time.
+ * See SliceScheduler for a scheduler built on this.
+ *
+ *   SolveRun run = solver.start(puzzle);
+ *   while (!solver.step(run, 50)) {
+ *       // ... do something else for a while ...
+ *   }
+ *   SolverResult result = run.result();
+ */
+template<int Order>
+class BasicSolveRun {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    BasicSolveRun() = default;
+
+    const Grid& puzzle() const { return puzzle_; }
+    bool finished() const { return finished_; }
+    int generation() const { return generation_; }
+    int best_fitness() const;
+    double elapsed_seconds() const { return elapsed_seconds_; }
+
+    // The outcome; only meaningful once finished()
+    const Result& result() const { return result_; }
+
+    // Give up now: finished, unsolved, with result().stopped set
+    void stop();
+
+private:
+    friend class BasicSolver<Order>;
+
+    Grid puzzle_;
+    BasicPopulation<Order> population_;
+    AdaptiveRates::State rates_{};
+    int generation_ = 0;
+    double elapsed_seconds_ = 0.0;
+    bool finished_ = false;
+    Result result_;
+
+    // Fill in result_ from the population
+    void finish(bool solved, bool stopped);
 };
 
 /*
@@ -42,28 +112,128 @@ struct SolverResult {
  *   Solver solver;
  *   SolverResult result = solver.solve(puzzle);
  *   if (result.solved) { ... }
+ *
+ * Solver handles 9x9 puzzles; use BasicSolver<4> (Solver16) or
+ * BasicSolver<5> (Solver25) for 16x16 and 25x25.
  */
-class Solver {
+template<int Order>
+class BasicSolver {
 public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Population = BasicPopulation<Order>;
+    using Result = BasicSolverResult<Order>;
+    using Run = BasicSolveRun<Order>;
+
     // You can pass custom params, or use the defaults
-    explicit Solver(const SolverParams& params = SolverParams{});
+    explicit BasicSolver(const SolverParams& params = SolverParams{});
 
     // Run the genetic algorithm on a puzzle
-    SolverResult solve(const SudokuGrid& puzzle);
+    Result solve(const Grid& puzzle);
+
+    // Continue a run from a checkpoint saved by an earlier solve() (see
+    // checkpoint_path). With the same params the result is exactly what
+    // the uninterrupted run would have produced. The population size comes
+    // from the checkpoint. Throws std::runtime_error if it can't be loaded.
+    Result resume(const Grid& puzzle, const std::string& checkpoint_path);
+
+    // The same solve, in pieces: start() builds the first generation and
+    // step() runs up to `generations` more. step() returns true once the
+    // run has finished (solved, out of generations, or stopped).
+    Run start(const Grid& puzzle);
+    bool step(Run& run, int generations);
 
     // Access the parameters (read or modify)
     const SolverParams& params() const { return params_; }
     SolverParams& params() { return params_; }
 
+    // Checked once per generation; when it returns true the solve ends
+    // right away, unsolved, with result.stopped set. Used for deadlines and
+    // cancellation (see SolverPool). An empty function means never stop.
+    void set_stop_condition(std::function<bool()> should_stop) { should_stop_ = std::move(should_stop); }
+
 private:
     SolverParams params_;
+    std::function<bool()> should_stop_;
+
+    // Next-generation buffer for run_generation, swapped with the
+    // population each generation so chromosomes are reused, not reallocated
+    std::vector<Chromosome> next_generation_;
+
+    // Crossover/mutation/local search rates actually in use. They only
+    // change during a solve if params_.adaptive_rates is set.
+    AdaptiveRates rates_;
 
     // Runs one generation: selection -> crossover -> mutation -> replacement
-    void run_generation(Population& population);
+    // Returns true if a solution was found (the generation may end early)
+    bool run_generation(Population& population);
+
+    // The offspring part of the above, split into jobs on the shared
+    // WorkStealingPool; returns how many slots are filled
+    size_t breed_parallel(Population& population, std::vector<Chromosome>& new_generation,
+                          size_t first, bool& solved);
+    std::vector<AdaptiveRates> job_rates(size_t count) const;
+
+    // start() and resume(); checkpoint is null for a fresh start
+    Run begin(const Grid& puzzle, const BasicCheckpoint<Order>* checkpoint);
+
+    // Restore rates_ and the random generator from a checkpoint
+    void restore(const BasicCheckpoint<Order>& checkpoint);
+
+    // Save a checkpoint if one is due after this generation
+    bool checkpoint_due(int generation) const;
+    void save(const Run& run, double elapsed_seconds);
+
+    // Start rates_ from params_ (at the beginning of every solve)
+    void reset_rates();
+
+    // Local search on one individual, as configured in params_
+    void apply_local_search(Chromosome& chrom, AdaptiveRates& rates);
+
+    // Smallest local_search_candidates that does anything for the strategy
+    int min_local_search_candidates() const;
+
+    // Mutation and local search on a freshly made child
+    void improve_child(Chromosome& child, AdaptiveRates& rates);
+
+    // Crossover (maybe), mutation and local search: two parents -> two children
+    void breed(const Chromosome& parent1, const Chromosome& parent2,
+               Chromosome& child1, Chromosome& child2, AdaptiveRates& rates);
 
     // Prints progress to console
-    void print_progress(int generation, const Population& population);
+    void print_progress(const Run& run);
 };
 
+/*
+ * solve_batch - Solve many puzzles using every core
+ *
+ * Each puzzle is one job on the shared WorkStealingPool, so a thread that
+ * finishes early takes the next puzzle instead of sitting idle while
+ * another works through a hard one. Each job gets its own solver, with
+ * progress printing and checkpoints turned off. With
+ * params.parallel_generation the generations are split up too, on the
+ * same threads. Results come back in the same order as the puzzles.
+ */
+template<int Order>
+std::vector<BasicSolverResult<Order>> solve_batch(const std::vector<BasicSudokuGrid<Order>>& puzzles,
+                                                  const SolverParams& params = SolverParams{});
+
+// The classic 9x9 solver
+using SolverResult = BasicSolverResult<3>;
+using Solver = BasicSolver<3>;
+using SolveRun = BasicSolveRun<3>;
+
+// Larger boards
+using Solver16 = BasicSolver<4>;
+using Solver25 = BasicSolver<5>;
+
+// Defined in Solver.cpp for these orders
+extern template class BasicSolveRun<3>;
+extern template class BasicSolveRun<4>;
+extern template class BasicSolveRun<5>;
+extern template class BasicSolver<3>;
+extern template class BasicSolver<4>;
+extern template class BasicSolver<5>;
+
 } // namespace sudoku_ga
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Solver.hpp"
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace sudoku_ga {
+
+/*
+ * Reading and writing SolverParams as text
+ *
+ * The format is one "name = value" per line, using the field names from
+ * SolverParams. Blank lines and lines starting with '#' are ignored, and
+ * fields that aren't mentioned keep their current value, e.g.:
+ *
+ *     # tuned on the "hard" corpus
+ *     population_size = 200
+ *     mutation_rate = 0.25
+ *     local_search_strategy = first_improvement
+ *
+ * Booleans are true/false, strategies are random, first_improvement or
+ * steepest_ascent. Rates must be within 0..1, population_size and
+ * tournament_size at least 1, local_search_candidates 1..
+ * AdaptiveRates::MAX_LOCAL_SEARCH_CANDIDATES, and the other numbers at
+ * least 0. Unknown names or bad values throw std::invalid_argument (with
+ * the line number).
+ *
+ * Rates are written with full precision, so they read back exactly.
+ */
+
+// Update params from the stream; returns the same object for convenience
+SolverParams& read_solver_params(std::istream& in, SolverParams& params);
+
+// Write every field, so the output can be read back as-is
+void write_solver_params(std::ostream& out, const SolverParams& params);
+
+// File versions of the above; throw std::runtime_error if the file can't be opened
+SolverParams load_solver_params(const std::string& path);
+void save_solver_params(const std::string& path, const SolverParams& params);
+
+} // namespace sudoku_ga
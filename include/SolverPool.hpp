@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Affinity.hpp"
+#include "Solver.hpp"
+#include "SudokuGrid.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * SolveOptions - How urgent one request is
+ */
+struct SolveOptions {
+    using Clock = std::chrono::steady_clock;
+
+    int priority = 0;                           // Higher runs first
+    Clock::time_point deadline = Clock::time_point::max();  // Give up at this time
+
+    // Convenience: a deadline this far from now
+    static SolveOptions within(std::chrono::milliseconds timeout, int priority = 0) {
+        SolveOptions options;
+        options.priority = priority;
+        options.deadline = Clock::now() + timeout;
+        return options;
+    }
+};
+
+// A pool's lock and its "there's room in the queue" signal. Queued tasks
+// keep a reference, so cancel() can wake a submit() waiting for room, and
+// is still safe to call once the pool is gone.
+struct SolveQueueSignal {
+    std::mutex mutex;
+    std::condition_variable room_ready;
+};
+
+// One request: shared by the queue, the worker running it and its handles
+template<int Order>
+struct BasicSolveTask {
+    using Result = BasicSolverResult<Order>;
+
+    BasicSudokuGrid<Order> puzzle;
+    SolveOptions options;
+    uint64_t sequence = 0;
+    std::promise<Result> promise;
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> claimed{false};   // Set by whoever fulfils the promise
+    std::shared_ptr<SolveQueueSignal> queue_signal;   // Null if nobody needs telling
+
+    bool should_stop() const {
+        return cancelled || SolveOptions::Clock::now() >= options.deadline;
+    }
+
+    // Queue order: higher priority, then earlier deadline, then first come
+    bool runs_after(const BasicSolveTask& other) const {
+        if (options.priority != other.options.priority) {
+            return options.priority < other.options.priority;
+        }
+        if (options.deadline != other.options.deadline) {
+            return options.deadline > other.options.deadline;
+        }
+        return sequence > other.sequence;
+    }
+
+    // Fulfil the promise with "stopped, never ran" unless someone else
+    // (a worker) already claimed the task
+    void finish_unrun() {
+        if (!claimed.exchange(true)) {
+            Result result;
+            result.stopped = true;
+            result.best_individual = BasicChromosome<Order>(puzzle);
+            promise.set_value(result);
+        }
+    }
+};
+
+/*
+ * BasicSolveHandle - What submit() gives back for one request
+ *
+ * Wait for the result with get() (or use future() directly), or cancel().
+ * Cancelling a request that hasn't started completes it at once; one that's
+ * running stops after its current generation. Either way the result
+ * arrives, with solved = false and stopped = true. Handles are cheap to copy.
+ */
+template<int Order>
+class BasicSolveHandle {
+public:
+    using Result = BasicSolverResult<Order>;
+
+    BasicSolveHandle() = default;
+
+    const std::shared_future<Result>& future() const { return future_; }
+    Result get() const { return future_.get(); }
+    bool ready() const {
+        return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void cancel() {
+        task_->cancelled = true;
+        task_->finish_unrun();
+
+        // Its queue slot is free now. Taking the lock first means a
+        // submit() that just found the queue full can't miss the wake-up.
+        if (const auto& signal = task_->queue_signal) {
+            { std::lock_guard<std::mutex> lock(signal->mutex); }
+            signal->room_ready.notify_all();
+        }
+    }
+
+private:
+    template<int> friend class BasicSolverPool;
+    template<int> friend class BasicSliceScheduler;
+
+    std::shared_ptr<BasicSolveTask<Order>> task_;
+    std::shared_future<Result> future_;
+};
+
+/*
+ * BasicSolverPool - Solve many puzzles concurrently, asynchronously
+ *
+ * A fixed set of worker threads, each with its own Solver (a Solver isn't
+ * meant to be shared between threads), takes requests from one queue.
+ * The queue is ordered by priority, then earliest deadline, then arrival.
+ *
+ * The queue holds at most max_queued waiting requests (cancelled ones
+ * don't count). When it's full, submit() blocks until there's room
+ * (backpressure) and try_submit() returns nothing.
+ *
+ * Requests whose deadline passes while they wait are completed without
+ * running, at the deadline, even if every worker is busy (a small expiry
+ * thread sleeps until the earliest one). Running requests are stopped at
+ * the next generation.
+ *
+ * Usage:
+ *   SolverPool pool;
+ *   auto handle = pool.submit(puzzle, SolveOptions::within(std::chrono::seconds(5)));
+ *   SolverResult result = handle.get();
+ *
+ * Workers can be pinned to cores (see Affinity.hpp); each builds its
+ * solver after pinning, so its memory is local to its core.
+ *
+ * Destroying the pool (or shutdown()) stops running solves, completes
+ * everything still queued as stopped, and joins the workers.
+ */
+template<int Order>
+class BasicSolverPool {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Result = BasicSolverResult<Order>;
+    using Handle = BasicSolveHandle<Order>;
+
+    // workers = 0 means one per core
+    explicit BasicSolverPool(const SolverParams& params = SolverParams{}, int workers = 0,
+                             size_t max_queued = 1024,
+                             AffinityPolicy affinity = AffinityPolicy::None);
+    ~BasicSolverPool();
+
+    BasicSolverPool(const BasicSolverPool&) = delete;
+    BasicSolverPool& operator=(const BasicSolverPool&) = delete;
+
+    // Queue a puzzle, waiting for room if the queue is full.
+    // Throws std::runtime_error after shutdown().
+    Handle submit(const Grid& puzzle, const SolveOptions& options = SolveOptions{});
+
+    // Queue a puzzle only if there's room right now
+    std::optional<Handle> try_submit(const Grid& puzzle, const SolveOptions& options = SolveOptions{});
+
+    void shutdown();
+
+    size_t queued() const;
+    size_t worker_count() const { return workers_.size(); }
+
+private:
+    using Task = BasicSolveTask<Order>;
+    using TaskPtr = std::shared_ptr<Task>;
+
+    struct LaterFirst {
+        bool operator()(const TaskPtr& a, const TaskPtr& b) const { return a->runs_after(*b); }
+    };
+
+    SolverParams params_;
+    size_t max_queued_;
+    AffinityPolicy affinity_;
+
+    std::shared_ptr<SolveQueueSignal> signal_;   // The lock, and room in the queue
+    std::condition_variable work_ready_;
+    std::condition_variable expiry_ready_;
+    std::vector<TaskPtr> queue_;                 // A heap ordered by LaterFirst
+    SolveOptions::Clock::time_point next_expiry_ = SolveOptions::Clock::time_point::max();
+    uint64_t next_sequence_ = 0;
+    std::atomic<bool> shutting_down_{false};
+
+    std::vector<std::thread> workers_;
+    std::thread expiry_thread_;
+
+    Handle enqueue(const Grid& puzzle, const SolveOptions& options, std::unique_lock<std::mutex>& lock);
+    bool has_room();
+    void remove_dead_tasks();
+    void worker_loop(size_t index);
+    void expiry_loop();
+};
+
+using SolveHandle = BasicSolveHandle<3>;
+using SolverPool = BasicSolverPool<3>;
+
+extern template class BasicSolverPool<3>;
+extern template class BasicSolverPool<4>;
+extern template class BasicSolverPool<5>;
+
+} // namespace sudoku_ga
@@ -1,97 +1,176 @@
 #pragma once
 
+#include "GridGeometry.hpp"
+
 #include <array>
 #include <cstdint>
+#include <memory_resource>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace sudoku_ga {
 
 /*
- * SudokuGrid - Represents a 9x9 Sudoku board
- * 
+ * BasicSudokuGrid - Represents an N x N Sudoku board, N = Order * Order
+ *
  * This class stores the puzzle state and provides methods to:
  * - Read and write cell values
  * - Track which cells are "fixed" (given in the original puzzle)
  * - Calculate fitness scores for the genetic algorithm
  * - Copy regions between grids (used during crossover)
- * 
- * The grid is laid out like this, with 9 sub-blocks numbered 0-8:
- * 
+ *
+ * Order is the size of one sub-block: 3 for the classic 9x9 board, 4 for
+ * 16x16 and 5 for 25x25. Every other constant is derived from it at compile
+ * time. SudokuGrid is the classic 9x9 board.
+ *
+ * The 9x9 grid is laid out like this, with 9 sub-blocks numbered 0-8:
+ *
  *     0 | 1 | 2
  *    ---+---+---
  *     3 | 4 | 5
  *    ---+---+---
  *     6 | 7 | 8
  */
-class SudokuGrid {
+template<int Order>
+class BasicSudokuGrid {
+    // Must match the explicit instantiations at the end of each .cpp file
+    static_assert(Order >= 3 && Order <= 5, "Supported block orders are 3 (9x9), 4 (16x16) and 5 (25x25)");
+
 public:
     // Basic Sudoku constants
-    static constexpr int SIZE = 9;
-    static constexpr int SUBBLOCK_SIZE = 3;
-    static constexpr int NUM_SUBBLOCKS = 9;
-    
-    // A perfect solution scores 162 (9 unique digits in each of 9 rows + 9 columns)
-    static constexpr int MAX_SCORE = 162;
+    static constexpr int SUBBLOCK_SIZE = Order;
+    static constexpr int SIZE = Order * Order;
+    static constexpr int NUM_SUBBLOCKS = SIZE;
+    static constexpr int NUM_CELLS = SIZE * SIZE;
+
+    // Cells are stored row-major in one byte each, padded up to a whole
+    // number of 32-byte vectors (96 bytes for 9x9) so SIMD code can load
+    // past the last cell without reading outside the grid. The padding is
+    // always 0 (empty).
+    static constexpr int PADDED_CELLS = (NUM_CELLS + 31) / 32 * 32;
+
+    // A perfect solution has SIZE unique digits in each of SIZE rows + SIZE columns
+    // (162 for 9x9)
+    static constexpr int MAX_SCORE = 2 * SIZE * SIZE;
+
+    // Which row, column and sub-block each cell is in, and so on (see
+    // GridGeometry.hpp); indexed by cell_index()
+    using Geometry = BasicGridGeometry<Order>;
+
+    // Wide enough to hold one bit per digit, bit 0 included
+    using DigitMask = std::conditional_t<(SIZE < 32), uint32_t, uint64_t>;
 
     // Creates an empty grid (all zeros)
-    SudokuGrid();
-    
+    BasicSudokuGrid();
+
     // Creates a grid from a string like "003020600900305..."
-    // Use '0' or '.' for empty cells, '1'-'9' for filled cells
-    explicit SudokuGrid(const std::string& puzzle);
+    // Use '0' or '.' for empty cells, '1'-'9' for filled cells, and
+    // 'A', 'B', ... (case-insensitive) for digits 10 and up on larger boards
+    explicit BasicSudokuGrid(const std::string& puzzle);
 
     // --- Basic cell access ---
-    int get(int row, int col) const;
-    void set(int row, int col, int value);
-    
+    int get(int row, int col) const { return cells_[cell_index(row, col)]; }
+    void set(int row, int col, int value) { cells_[cell_index(row, col)] = static_cast<uint8_t>(value); }
+
     // Fixed cells are the ones given in the original puzzle.
     // The GA should never modify these.
-    bool is_fixed(int row, int col) const;
+    bool is_fixed(int row, int col) const { return fixed_[cell_index(row, col)]; }
+
+    // Place a value and mark it fixed, as if it had been given in the puzzle
+    // (used when a cell's value has been deduced for certain)
+    void set_given(int row, int col, int value) {
+        set(row, col, value);
+        fixed_[cell_index(row, col)] = true;
+    }
+
+    // --- Flat cell access ---
+    // Cells can also be addressed by one index, 0 to NUM_CELLS - 1, going
+    // left-to-right, top-to-bottom (cell = row * SIZE + col)
+    static constexpr int cell_index(int row, int col) { return row * SIZE + col; }
+
+    int get(int cell) const { return cells_[cell]; }
+    void set(int cell, int value) { cells_[cell] = static_cast<uint8_t>(value); }
+    bool is_fixed(int cell) const { return fixed_[cell]; }
+
+    // All PADDED_CELLS cell values, row-major (for SIMD kernels)
+    const uint8_t* cells() const { return cells_.data(); }
 
     // --- Fitness scoring ---
-    // These count how many unique digits (1-9) appear in a row/column.
-    // A perfect row or column scores 9.
+    // These count how many unique digits appear in a row/column.
+    // A perfect row or column scores SIZE.
     int get_row_score(int row) const;
     int get_column_score(int col) const;
     int get_total_score() const;
-    
-    // Scores for "bands" (3 consecutive rows) and "stacks" (3 consecutive columns).
-    // Used during crossover to compare which parent has better regions.
-    // band_index and stack_index can be 0, 1, or 2.
+
+    // Scores for "bands" (Order consecutive rows) and "stacks" (Order
+    // consecutive columns). Used during crossover to compare which parent
+    // has better regions. band_index and stack_index go from 0 to Order - 1.
     int get_row_band_score(int band_index) const;
     int get_column_stack_score(int stack_index) const;
 
     // --- Sub-block helpers ---
-    // Get positions of non-fixed cells in a sub-block (for mutation)
-    std::vector<std::pair<int, int>> get_subblock_non_fixed_positions(int subblock_index) const;
-    
-    // Convert sub-block index (0-8) to grid coordinates of its top-left corner
+    // Get the flat indices of non-fixed cells in a sub-block (for mutation)
+    // (allocated from the thread's ScratchArena unless told otherwise)
+    std::pmr::vector<int> get_subblock_non_fixed_cells(
+        int subblock_index, std::pmr::memory_resource* memory = nullptr) const;
+
+    // Convert sub-block index to grid coordinates of its top-left corner
     static std::pair<int, int> subblock_top_left(int subblock_index);
 
     // --- Crossover helpers ---
-    // Copy 3 rows at a time from another grid
-    void copy_row_band_from(const SudokuGrid& other, int band_index);
-    
-    // Copy 3 columns at a time from another grid
-    void copy_column_stack_from(const SudokuGrid& other, int stack_index);
+    // Copy a band of rows at a time from another grid
+    void copy_row_band_from(const BasicSudokuGrid& other, int band_index);
+
+    // Copy a stack of columns at a time from another grid
+    void copy_column_stack_from(const BasicSudokuGrid& other, int stack_index);
 
     // Returns true when the puzzle is completely solved
     bool is_solved() const;
 
-    // For printing the grid nicely
-    friend std::ostream& operator<<(std::ostream& os, const SudokuGrid& grid);
+    // Is this grid a complete, valid solution of the puzzle? Unlike
+    // is_solved(), this also checks sub-blocks and the puzzle's givens, so
+    // it can be used on grids that didn't come from the GA (e.g. caches).
+    bool solves(const BasicSudokuGrid& puzzle) const;
+
+    // Character used for a digit in puzzle strings and printing ('.' for 0)
+    static char digit_to_char(int value);
+
+    // Inverse of digit_to_char; returns 0 for anything that isn't a digit
+    static int char_to_digit(char c);
 
 private:
-    // The actual 9x9 grid of values (0 means empty)
-    std::array<std::array<int, SIZE>, SIZE> grid_;
-    
-    // Tracks which cells came from the original puzzle
-    std::array<std::array<bool, SIZE>, SIZE> fixed_;
-    
-    // Counts unique non-zero values in an array (used for scoring)
-    static int count_unique(const std::array<int, SIZE>& values);
+    // The actual grid of values (0 means empty), one byte per cell, starting
+    // on a cache line so copying or loading a grid touches as few lines as
+    // possible (a whole 9x9 grid with its fixed flags is 192 bytes)
+    alignas(64) std::array<uint8_t, PADDED_CELLS> cells_;
+
+    // Tracks which cells came from the original puzzle (same layout)
+    std::array<bool, PADDED_CELLS> fixed_;
+
+    // Counts unique non-zero values in a row or column (used for scoring)
+    int count_unique(const typename Geometry::Unit& unit) const;
 };
 
+// For printing the grid nicely
+template<int Order>
+std::ostream& operator<<(std::ostream& os, const BasicSudokuGrid<Order>& grid);
+
+// The grid as a string, row by row (digit_to_char, '.' for empty)
+template<int Order>
+std::string grid_to_string(const BasicSudokuGrid<Order>& grid);
+
+// The classic 9x9 board
+using SudokuGrid = BasicSudokuGrid<3>;
+
+// Larger boards
+using SudokuGrid16 = BasicSudokuGrid<4>;
+using SudokuGrid25 = BasicSudokuGrid<5>;
+
+// Defined in SudokuGrid.cpp for these orders
+extern template class BasicSudokuGrid<3>;
+extern template class BasicSudokuGrid<4>;
+extern template class BasicSudokuGrid<5>;
+
 }  // namespace sudoku_ga
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Chromosome.hpp"
+#include "GeneticOperations.hpp"
+#include "Solver.hpp"
+#include "SudokuGrid.hpp"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace sudoku_ga {
+
+/*
+ * TabuParams - Configuration for the tabu search solver
+ */
+struct TabuParams {
+    int tabu_tenure = 10;             // Iterations a swapped pair of cells stays tabu
+    int tenure_jitter = 5;            // Plus a random 0..jitter, so cycles are less likely
+    int max_iterations = 200000;      // Give up after this many moves
+    int perturb_after = 2000;         // Shake up the grid after this many moves without a new best (0 = never)
+    int perturb_swaps = 10;           // How many random swaps a shake-up makes
+    int report_interval = 10000;      // Print progress every N iterations (0 = quiet)
+};
+
+/*
+ * TabuSolver - Tabu search on the same representation as the GA
+ *
+ * One chromosome, moved by swapping two free cells of a sub-block. Every
+ * iteration looks at every such swap (with apply_swap()'s delta, so it's
+ * cheap) and takes the best one that isn't tabu, even if it makes things
+ * worse. The two cells it swapped then can't be swapped together again for
+ * a few iterations, which stops the search from undoing its own moves.
+ *
+ * Aspiration: a tabu move is allowed anyway if it beats the best fitness
+ * seen so far.
+ *
+ * SolverResult::generations is the number of iterations (moves).
+ */
+template<int Order>
+class BasicTabuSolver {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Chromosome = BasicChromosome<Order>;
+    using Result = BasicSolverResult<Order>;
+
+    explicit BasicTabuSolver(const TabuParams& params = TabuParams{});
+
+    Result solve(const Grid& puzzle);
+
+    const TabuParams& params() const { return params_; }
+    TabuParams& params() { return params_; }
+
+    // Checked once per iteration; see BasicSolver::set_stop_condition
+    void set_stop_condition(std::function<bool()> should_stop) { should_stop_ = std::move(should_stop); }
+
+private:
+    TabuParams params_;
+    std::function<bool()> should_stop_;
+
+    // Free cells of every sub-block with at least two of them
+    std::vector<std::vector<int>> free_cells_;
+
+    // tabu_until_[cell][partner] = first iteration at which swapping the
+    // cell with the partner (its position inside the same sub-block) is
+    // allowed again. NUM_CELLS x SIZE entries - small even on 25x25.
+    std::vector<int> tabu_until_;
+
+    int& tabu_entry(int cell, int partner_cell);
+    void make_tabu(const CellSwap& swap, int until);
+    bool is_tabu(const CellSwap& swap, int iteration);
+
+    // Pick the move to make this iteration; false if there's nothing to do
+    bool best_move(Chromosome& current, int best_fitness, int iteration,
+                   CellSwap& move, int& move_delta);
+
+    void perturb(Chromosome& current);
+};
+
+using TabuSolver = BasicTabuSolver<3>;
+
+extern template class BasicTabuSolver<3>;
+extern template class BasicTabuSolver<4>;
+extern template class BasicTabuSolver<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Affinity.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sudoku_ga {
+
+class TaskGroup;
+
+/*
+ * WorkStealingPool - Threads that share out small jobs
+ *
+ * Every worker has its own deque of jobs. A worker adds jobs it creates to
+ * the back of its own deque and takes from the back too (the newest job,
+ * whose data is still in cache). A worker with nothing to do steals from
+ * the front of someone else's deque (the oldest job, usually the biggest).
+ * Busy workers rarely touch each other's deques, and idle ones find work
+ * without anyone handing it out.
+ *
+ * Jobs come in TaskGroups (see below). A thread waiting for a group helps
+ * run that group's jobs instead of blocking, so work can nest (a batch of
+ * solves, each splitting its generations into jobs) on the same threads
+ * without creating more threads than cores.
+ *
+ * Workers can be pinned to cores (see Affinity.hpp).
+ *
+ * Most code uses the one shared pool:
+ *   TaskGroup group(WorkStealingPool::shared());
+ *   for (...) group.run([...] { ... });
+ *   group.wait();
+ */
+class WorkStealingPool {
+public:
+    // workers = 0 means one per core
+    explicit WorkStealingPool(int workers = 0, AffinityPolicy affinity = AffinityPolicy::None);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // The library-wide pool, started on first use with one thread per core
+    static WorkStealingPool& shared();
+
+    // How shared() pins its workers; only takes effect before its first use
+    static void set_shared_affinity(AffinityPolicy affinity);
+
+    size_t worker_count() const { return workers_.size(); }
+
+private:
+    friend class TaskGroup;
+
+    struct Job {
+        std::function<void()> work;
+        TaskGroup* group;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    AffinityPolicy affinity_;
+
+    std::atomic<size_t> queued_{0};         // Jobs in all deques
+    std::atomic<size_t> next_victim_{0};    // Where outside threads put jobs
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stopping_ = false;
+
+    void push(Job job);
+
+    // Take and run one job, from this thread's own deque first, then by
+    // stealing. With a group, only that group's jobs. False if none.
+    bool run_one(const TaskGroup* group = nullptr);
+    bool take(Worker& worker, bool from_back, const TaskGroup* group, Job& job);
+
+    void worker_loop(size_t index);
+};
+
+/*
+ * TaskGroup - Jobs that are waited for together
+ *
+ * run() adds a job to the pool; wait() returns once all of them are done
+ * and rethrows the first exception any of them threw. The destructor waits
+ * too, so jobs can safely refer to locals that outlive the group.
+ *
+ * wait() runs the group's jobs itself while any are left in the deques,
+ * then sleeps until the last one running elsewhere finishes.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool = WorkStealingPool::shared()) : pool_(pool) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> work);
+    void wait();
+
+    WorkStealingPool& pool() { return pool_; }
+
+private:
+    friend class WorkStealingPool;
+
+    WorkStealingPool& pool_;
+    std::atomic<size_t> pending_{0};
+    std::mutex mutex_;                  // Guards error_; the last job signals done_
+    std::condition_variable done_;
+    std::exception_ptr error_;
+
+    void execute(std::function<void()>& work);
+};
+
+} // namespace sudoku_ga
@@ -1,6 +1,8 @@
 #include "Solver.hpp"
+#include "SolverParamsIO.hpp"
 #include "SudokuGrid.hpp"
 
+#include <exception>
 #include <iostream>
 
 /*
@@ -19,9 +21,13 @@
  *     . . 9 | 3 . . | . 7 4
  *     . 4 . | . 5 . | . 3 6
  *     7 . 3 | . 1 8 | . . .
+ *
+ * Optionally pass a parameter file (e.g. one written by sudoku_ga_tune):
+ *
+ *     sudoku_genetic_algorithms tuned_params.txt
  */
 
-int main() {
+int main(int argc, char* argv[]) {
     // Create the puzzle from a string (81 characters, 0 = empty)
     auto puzzle = sudoku_ga::SudokuGrid(
         "000260701"
@@ -35,9 +41,18 @@ int main() {
         "703018000"
     );
     
-    // Create a solver with default parameters
+    // Create a solver with default parameters, or the ones from the file
     // You can customize: population_size, mutation_rate, etc.
-    auto solver = sudoku_ga::Solver();
+    sudoku_ga::SolverParams params;
+    if (argc > 1) {
+        try {
+            params = sudoku_ga::load_solver_params(argv[1]);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    auto solver = sudoku_ga::Solver(params);
     
     // Run the genetic algorithm
     auto result = solver.solve(puzzle);
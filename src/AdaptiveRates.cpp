@@ -0,0 +1,121 @@
+#include "AdaptiveRates.hpp"
+
+#include <algorithm>
+
+namespace sudoku_ga {
+
+namespace {
+
+// How quickly the arm qualities follow new results (0 = never, 1 = instantly)
+constexpr double QUALITY_SMOOTHING = 0.3;
+
+// The 1/5 success rule, and how much the mutation rate moves each generation
+constexpr double TARGET_MUTATION_SUCCESS = 0.2;
+constexpr double MUTATION_STEP = 1.1;
+
+// Local search grows above this success rate and shrinks below the other
+constexpr double LOCAL_SEARCH_GROW = 0.3;
+constexpr double LOCAL_SEARCH_SHRINK = 0.1;
+
+} // namespace
+
+void AdaptiveRates::reset(double crossover_rate, double mutation_rate,
+                          int local_search_candidates, int min_candidates) {
+    *this = AdaptiveRates();
+    crossover_rate_ = crossover_rate;
+    mutation_rate_ = mutation_rate;
+    local_search_candidates_ = std::clamp(local_search_candidates, min_candidates,
+                                          MAX_LOCAL_SEARCH_CANDIDATES);
+    min_candidates_ = min_candidates;
+}
+
+void AdaptiveRates::record_offspring(bool crossed, bool improved) {
+    if (crossed) {
+        ++crossover_children_;
+        crossover_improved_ += improved;
+    } else {
+        ++copy_children_;
+        copy_improved_ += improved;
+    }
+}
+
+void AdaptiveRates::record_mutation(bool improved) {
+    ++mutations_;
+    mutations_improved_ += improved;
+}
+
+void AdaptiveRates::record_local_search(bool improved) {
+    ++local_searches_;
+    local_searches_improved_ += improved;
+}
+
+void AdaptiveRates::add_feedback(const AdaptiveRates& other) {
+    crossover_children_ += other.crossover_children_;
+    crossover_improved_ += other.crossover_improved_;
+    copy_children_ += other.copy_children_;
+    copy_improved_ += other.copy_improved_;
+    mutations_ += other.mutations_;
+    mutations_improved_ += other.mutations_improved_;
+    local_searches_ += other.local_searches_;
+    local_searches_improved_ += other.local_searches_improved_;
+}
+
+void AdaptiveRates::end_generation() {
+    // Crossover: probability matching between the two arms
+    if (crossover_children_ > 0) {
+        double rate = static_cast<double>(crossover_improved_) / crossover_children_;
+        crossover_quality_ += QUALITY_SMOOTHING * (rate - crossover_quality_);
+    }
+    if (copy_children_ > 0) {
+        double rate = static_cast<double>(copy_improved_) / copy_children_;
+        copy_quality_ += QUALITY_SMOOTHING * (rate - copy_quality_);
+    }
+    double total_quality = crossover_quality_ + copy_quality_;
+    if (total_quality > 0.0) {
+        crossover_rate_ = MIN_PROBABILITY +
+            (1.0 - 2.0 * MIN_PROBABILITY) * crossover_quality_ / total_quality;
+    }
+
+    // Mutation: 1/5 success rule
+    if (mutations_ > 0) {
+        double success = static_cast<double>(mutations_improved_) / mutations_;
+        mutation_rate_ = success > TARGET_MUTATION_SUCCESS
+            ? mutation_rate_ * MUTATION_STEP
+            : mutation_rate_ / MUTATION_STEP;
+        mutation_rate_ = std::clamp(mutation_rate_, MIN_PROBABILITY, MAX_MUTATION_RATE);
+    }
+
+    // Local search: spend more effort where it pays off
+    if (local_searches_ > 0) {
+        double success = static_cast<double>(local_searches_improved_) / local_searches_;
+        if (success > LOCAL_SEARCH_GROW) {
+            ++local_search_candidates_;
+        } else if (success < LOCAL_SEARCH_SHRINK) {
+            --local_search_candidates_;
+        }
+        local_search_candidates_ = std::clamp(local_search_candidates_, min_candidates_,
+                                              MAX_LOCAL_SEARCH_CANDIDATES);
+    }
+
+    crossover_children_ = crossover_improved_ = 0;
+    copy_children_ = copy_improved_ = 0;
+    mutations_ = mutations_improved_ = 0;
+    local_searches_ = local_searches_improved_ = 0;
+}
+
+AdaptiveRates::State AdaptiveRates::state() const {
+    return State{crossover_rate_, mutation_rate_, local_search_candidates_, min_candidates_,
+                 crossover_quality_, copy_quality_};
+}
+
+void AdaptiveRates::restore(const State& state) {
+    *this = AdaptiveRates();
+    crossover_rate_ = state.crossover_rate;
+    mutation_rate_ = state.mutation_rate;
+    local_search_candidates_ = state.local_search_candidates;
+    min_candidates_ = state.min_candidates;
+    crossover_quality_ = state.crossover_quality;
+    copy_quality_ = state.copy_quality;
+}
+
+} // namespace sudoku_ga
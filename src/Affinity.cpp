@@ -0,0 +1,165 @@
+#include "Affinity.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#define SUDOKU_GA_LINUX 1
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sudoku_ga {
+
+namespace {
+
+// Parse a kernel CPU list such as "0-3,8,10-11"
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::istringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Blank or malformed piece; skip it
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef SUDOKU_GA_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+std::vector<std::vector<int>> read_cpu_nodes() {
+    std::vector<int> allowed = allowed_cpus();
+    if (allowed.empty()) {
+        return {};
+    }
+
+    // Node of each CPU, from sysfs; CPUs it doesn't mention go to node 0
+    std::map<int, int> node_of;
+    for (int node = 0; node < 1024; ++node) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in) {
+            if (node > 0) break;   // Nodes are numbered from 0 without gaps (almost always)
+            continue;
+        }
+        std::string list;
+        std::getline(in, list);
+        for (int cpu : parse_cpu_list(list)) {
+            node_of[cpu] = node;
+        }
+    }
+
+    std::map<int, std::vector<int>> by_node;
+    for (int cpu : allowed) {
+        auto it = node_of.find(cpu);
+        by_node[it == node_of.end() ? 0 : it->second].push_back(cpu);
+    }
+
+    std::vector<std::vector<int>> nodes;
+    for (auto& entry : by_node) {
+        nodes.push_back(std::move(entry.second));
+    }
+    return nodes;
+}
+
+} // namespace
+
+const char* affinity_policy_name(AffinityPolicy policy) {
+    switch (policy) {
+        case AffinityPolicy::Compact: return "compact";
+        case AffinityPolicy::Spread: return "spread";
+        case AffinityPolicy::None: break;
+    }
+    return "none";
+}
+
+AffinityPolicy parse_affinity_policy(const std::string& name) {
+    if (name == "none") return AffinityPolicy::None;
+    if (name == "compact") return AffinityPolicy::Compact;
+    if (name == "spread") return AffinityPolicy::Spread;
+    throw std::invalid_argument("Unknown affinity policy: " + name);
+}
+
+const std::vector<std::vector<int>>& cpu_nodes() {
+    static const std::vector<std::vector<int>> nodes = read_cpu_nodes();
+    return nodes;
+}
+
+int worker_cpu(AffinityPolicy policy, size_t worker) {
+    const auto& nodes = cpu_nodes();
+    if (policy == AffinityPolicy::None || nodes.empty()) {
+        return -1;
+    }
+
+    size_t total = 0;
+    for (const auto& node : nodes) {
+        total += node.size();
+    }
+    // More workers than CPUs: wrap around and share
+    worker %= total;
+
+    if (policy == AffinityPolicy::Compact) {
+        for (const auto& node : nodes) {
+            if (worker < node.size()) {
+                return node[worker];
+            }
+            worker -= node.size();
+        }
+        return -1;
+    }
+
+    // Spread: worker 0 on node 0, worker 1 on node 1, ... skipping nodes
+    // that have run out of CPUs
+    std::vector<size_t> used(nodes.size(), 0);
+    for (size_t n = 0;; n = (n + 1) % nodes.size()) {
+        if (used[n] == nodes[n].size()) {
+            continue;
+        }
+        if (worker == 0) {
+            return nodes[n][used[n]];
+        }
+        ++used[n];
+        --worker;
+    }
+}
+
+bool pin_current_thread(AffinityPolicy policy, size_t worker) {
+    int cpu = worker_cpu(policy, worker);
+    if (cpu < 0) {
+        return false;
+    }
+#ifdef SUDOKU_GA_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace sudoku_ga
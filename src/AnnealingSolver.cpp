@@ -0,0 +1,184 @@
+#include "AnnealingSolver.hpp"
+#include "GeneticOperations.hpp"
+#include "RandomUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace sudoku_ga {
+
+template<int Order>
+BasicAnnealingSolver<Order>::BasicAnnealingSolver(const AnnealingParams& params)
+    : params_(params)
+{}
+
+template<int Order>
+void BasicAnnealingSolver<Order>::find_free_cells(const Grid& puzzle) {
+    free_cells_.clear();
+    for (int block = 0; block < Grid::NUM_SUBBLOCKS; ++block) {
+        auto cells = puzzle.get_subblock_non_fixed_cells(block);
+        if (cells.size() >= 2) {
+            // Kept for the whole solve, so copied out of the scratch arena
+            free_cells_.emplace_back(cells.begin(), cells.end());
+        }
+    }
+}
+
+template<int Order>
+CellSwap BasicAnnealingSolver<Order>::random_move() const {
+    const auto& cells = free_cells_[rng().rand_int(0, static_cast<int>(free_cells_.size()) - 1)];
+    auto [i, j] = rng().two_distinct_indices(static_cast<int>(cells.size()) - 1);
+    return CellSwap{cells[i], cells[j]};
+}
+
+// Try a batch of random moves (undoing each one) and use the standard
+// deviation of their fitness changes as the starting temperature
+template<int Order>
+double BasicAnnealingSolver<Order>::estimate_temperature(Chromosome& chrom) const {
+    const int samples = 200;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    for (int i = 0; i < samples; ++i) {
+        CellSwap move = random_move();
+        double delta = apply_swap(chrom.grid(), move);
+        swap_cells(chrom.grid(), move);
+        sum += delta;
+        sum_sq += delta * delta;
+    }
+
+    double mean = sum / samples;
+    double variance = sum_sq / samples - mean * mean;
+    return std::max(std::sqrt(std::max(variance, 0.0)), 1.0);
+}
+
+template<int Order>
+double BasicAnnealingSolver<Order>::cool(double temperature, double initial_temperature) const {
+    switch (params_.schedule) {
+        case CoolingSchedule::Linear:
+            return temperature - initial_temperature * (1.0 - params_.cooling_rate);
+        case CoolingSchedule::LundyMees: {
+            double beta = (1.0 - params_.cooling_rate) / initial_temperature;
+            return temperature / (1.0 + beta * temperature);
+        }
+        case CoolingSchedule::Geometric:
+            break;
+    }
+    return temperature * params_.cooling_rate;
+}
+
+// Main annealing loop
+template<int Order>
+BasicSolverResult<Order> BasicAnnealingSolver<Order>::solve(const Grid& puzzle) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    Result result;
+
+    Chromosome current(puzzle);
+    current.initialize_random();
+    Chromosome best = current;
+
+    find_free_cells(puzzle);
+
+    // No two free cells in any sub-block: the random fill is the only option
+    if (free_cells_.empty() || current.is_solution()) {
+        result.solved = current.is_solution();
+        result.best_fitness = current.fitness();
+        result.best_individual = current;
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+        return result;
+    }
+
+    int chain_length = params_.chain_length;
+    if (chain_length <= 0) {
+        int free_count = 0;
+        for (const auto& cells : free_cells_) {
+            free_count += static_cast<int>(cells.size());
+        }
+        chain_length = free_count * free_count;
+    }
+
+    double initial_temperature = params_.initial_temperature > 0.0
+        ? params_.initial_temperature
+        : estimate_temperature(current);
+    double temperature = initial_temperature;
+
+    int fitness = current.fitness();
+    int steps_since_best = 0;
+    int step = 0;
+    bool stopped = false;
+
+    while (step < params_.max_steps && !best.is_solution()) {
+        if (should_stop_ && should_stop_()) {
+            stopped = true;
+            break;
+        }
+        ++step;
+
+        // One Markov chain at the current temperature
+        bool new_best = false;
+        for (int move_index = 0; move_index < chain_length; ++move_index) {
+            CellSwap move = random_move();
+            int delta = apply_swap(current.grid(), move);
+
+            // Always accept improvements, sometimes accept worse moves
+            if (delta >= 0 || rng().rand_double() < std::exp(delta / temperature)) {
+                fitness += delta;
+                if (fitness > best.fitness()) {
+                    current.set_fitness(fitness);
+                    best = current;
+                    new_best = true;
+                    if (best.is_solution()) {
+                        break;
+                    }
+                }
+            } else {
+                swap_cells(current.grid(), move);
+            }
+        }
+        steps_since_best = new_best ? 0 : steps_since_best + 1;
+
+        // Cool down, or heat back up if we've been stuck for a while
+        temperature = cool(temperature, initial_temperature);
+        bool stalled = params_.reheat_after > 0 && steps_since_best >= params_.reheat_after;
+        if (stalled || temperature < params_.min_temperature) {
+            if (params_.reheat_after <= 0) {
+                break;
+            }
+            temperature = initial_temperature * params_.reheat_fraction;
+            steps_since_best = 0;
+        }
+
+        if (params_.report_interval > 0 && step % params_.report_interval == 0) {
+            std::cout << "Step " << step
+                      << " | Temperature: " << temperature
+                      << " | Current: " << fitness
+                      << " | Best: " << best.fitness()
+                      << std::endl;
+        }
+    }
+
+    result.solved = best.is_solution();
+    result.stopped = stopped;
+    result.generations = step;
+    result.best_fitness = best.fitness();
+    result.best_individual = best;
+
+    if (result.solved && params_.report_interval > 0) {
+        std::cout << "Solution found at step " << step << "!" << std::endl;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+    return result;
+}
+
+template class BasicAnnealingSolver<3>;
+template class BasicAnnealingSolver<4>;
+template class BasicAnnealingSolver<5>;
+
+} // namespace sudoku_ga
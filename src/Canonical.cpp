@@ -0,0 +1,304 @@
+#include "Canonical.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace sudoku_ga {
+
+// =============================================================================
+// Applying transforms
+// =============================================================================
+
+template<int Order>
+BasicSudokuGrid<Order> BasicGridTransform<Order>::apply(const Grid& grid) const {
+    Grid result;
+    for (int row = 0; row < SIZE; ++row) {
+        for (int col = 0; col < SIZE; ++col) {
+            int src_row = row_map[row];
+            int src_col = col_map[col];
+            if (transpose) {
+                std::swap(src_row, src_col);
+            }
+
+            int value = relabel[grid.get(src_row, src_col)];
+            if (grid.is_fixed(src_row, src_col)) {
+                result.set_given(row, col, value);
+            } else {
+                result.set(row, col, value);
+            }
+        }
+    }
+    return result;
+}
+
+template<int Order>
+BasicSudokuGrid<Order> BasicGridTransform<Order>::invert(const Grid& grid) const {
+    std::array<int, SIZE + 1> unlabel{};
+    for (int digit = 1; digit <= SIZE; ++digit) {
+        unlabel[relabel[digit]] = digit;
+    }
+
+    Grid result;
+    for (int row = 0; row < SIZE; ++row) {
+        for (int col = 0; col < SIZE; ++col) {
+            int dst_row = row_map[row];
+            int dst_col = col_map[col];
+            if (transpose) {
+                std::swap(dst_row, dst_col);
+            }
+
+            int value = unlabel[grid.get(row, col)];
+            if (grid.is_fixed(row, col)) {
+                result.set_given(dst_row, dst_col, value);
+            } else {
+                result.set(dst_row, dst_col, value);
+            }
+        }
+    }
+    return result;
+}
+
+// =============================================================================
+// Canonical form search
+// =============================================================================
+
+namespace {
+
+/*
+ * Branch and bound over the symmetries
+ *
+ * For each orientation and column order, the output is built one row at a
+ * time by picking which source row goes next (a new band, or another row
+ * of the current band). Digits are relabeled in order of first appearance,
+ * which is what makes the string smallest for a given arrangement.
+ *
+ * As soon as the rows built so far compare greater than the best string
+ * found, the branch can't win and is dropped. Most branches die on the
+ * first row.
+ */
+template<int Order>
+class CanonicalSearch {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Transform = BasicGridTransform<Order>;
+
+    static constexpr int SIZE = Grid::SIZE;
+    static constexpr int NUM_CELLS = Grid::NUM_CELLS;
+
+    // Only 9x9 tries every row and column order (see canonical_transform)
+    static constexpr bool FULL_SYMMETRY = Order == 3;
+
+    explicit CanonicalSearch(const Grid& puzzle) {
+        for (int row = 0; row < SIZE; ++row) {
+            for (int col = 0; col < SIZE; ++col) {
+                oriented_[0][row * SIZE + col] = puzzle.get(row, col);
+                oriented_[1][row * SIZE + col] = puzzle.get(col, row);
+            }
+        }
+    }
+
+    Transform run() {
+        auto col_maps = column_maps();
+
+        // Phase 1: the smallest possible first row, and every way to get it
+        struct Start {
+            int transpose;
+            int col_map;
+            int src_row;
+        };
+        std::vector<Start> starts;
+        std::array<int, SIZE> min_row{};
+        int source_rows = FULL_SYMMETRY ? SIZE : 1;
+
+        for (int transpose = 0; transpose < 2; ++transpose) {
+            for (int m = 0; m < static_cast<int>(col_maps.size()); ++m) {
+                for (int src_row = 0; src_row < source_rows; ++src_row) {
+                    std::array<int, SIZE + 1> labels{};
+                    std::array<int, SIZE> row{};
+                    label_row(oriented_[transpose], src_row, col_maps[m], labels, 1, row.data());
+
+                    if (starts.empty() || row < min_row) {
+                        starts.clear();
+                        min_row = row;
+                    } else if (row != min_row) {
+                        continue;
+                    }
+                    starts.push_back({transpose, m, src_row});
+                }
+            }
+        }
+
+        // Phase 2: finish the search from each of those starts only
+        for (const Start& start : starts) {
+            current_.transpose = start.transpose == 1;
+            current_.col_map = col_maps[start.col_map];
+            current_.row_map[0] = start.src_row;
+
+            std::array<int, SIZE + 1> labels{};
+            int next = label_row(oriented_[start.transpose], start.src_row, current_.col_map,
+                                 labels, 1, current_cells_.data());
+            search_rows(1, labels, next, 1u << start.src_row);
+        }
+        return best_;
+    }
+
+private:
+    std::array<std::array<int, NUM_CELLS>, 2> oriented_{};
+    Transform current_;
+    Transform best_;
+    std::array<int, NUM_CELLS> current_cells_{};
+    std::array<int, NUM_CELLS> best_cells_{};
+    bool have_best_ = false;
+
+    // Every column order: stacks in any order, columns in any order inside them
+    static std::vector<std::array<int, SIZE>> column_maps() {
+        std::array<int, SIZE> identity{};
+        std::iota(identity.begin(), identity.end(), 0);
+        if (!FULL_SYMMETRY) {
+            return {identity};
+        }
+
+        std::vector<std::array<int, Order>> inner;
+        std::array<int, Order> perm{};
+        std::iota(perm.begin(), perm.end(), 0);
+        do {
+            inner.push_back(perm);
+        } while (std::next_permutation(perm.begin(), perm.end()));
+
+        std::vector<std::array<int, SIZE>> maps;
+        std::array<int, Order> stacks{};
+        std::iota(stacks.begin(), stacks.end(), 0);
+        do {
+            // Odometer over the inner order of each stack
+            std::array<int, Order> choice{};
+            while (true) {
+                std::array<int, SIZE> map{};
+                for (int s = 0; s < Order; ++s) {
+                    for (int k = 0; k < Order; ++k) {
+                        map[s * Order + k] = stacks[s] * Order + inner[choice[s]][k];
+                    }
+                }
+                maps.push_back(map);
+
+                int s = 0;
+                while (s < Order && ++choice[s] == static_cast<int>(inner.size())) {
+                    choice[s++] = 0;
+                }
+                if (s == Order) {
+                    break;
+                }
+            }
+        } while (std::next_permutation(stacks.begin(), stacks.end()));
+        return maps;
+    }
+
+    // Write one source row in output order, giving new digits the next
+    // labels. Returns the next unused label.
+    static int label_row(const std::array<int, NUM_CELLS>& cells, int src_row,
+                         const std::array<int, SIZE>& col_map, std::array<int, SIZE + 1>& labels,
+                         int next_label, int* out) {
+        for (int col = 0; col < SIZE; ++col) {
+            int value = cells[src_row * SIZE + col_map[col]];
+            if (value != 0 && labels[value] == 0) {
+                labels[value] = next_label++;
+            }
+            out[col] = labels[value];
+        }
+        return next_label;
+    }
+
+    // Is the output so far (the first `rows` rows) no greater than the best?
+    bool prefix_not_worse(int rows) const {
+        if (!have_best_) {
+            return true;
+        }
+        int end = rows * SIZE;
+        for (int i = 0; i < end; ++i) {
+            if (current_cells_[i] != best_cells_[i]) {
+                return current_cells_[i] < best_cells_[i];
+            }
+        }
+        return true;
+    }
+
+    void search_rows(int out_row, const std::array<int, SIZE + 1>& relabel, int next_label,
+                     unsigned used_rows) {
+        if (out_row == SIZE) {
+            record_leaf(relabel, next_label);
+            return;
+        }
+
+        // A new band can come from any unused band; otherwise stay in the
+        // band of the previous row
+        int first_band = 0;
+        int last_band = Order - 1;
+        if (out_row % Order != 0) {
+            first_band = last_band = current_.row_map[out_row - 1] / Order;
+        }
+
+        const auto& cells = oriented_[current_.transpose ? 1 : 0];
+
+        for (int band = first_band; band <= last_band; ++band) {
+            for (int k = 0; k < Order; ++k) {
+                int src_row = band * Order + k;
+                if (!FULL_SYMMETRY && src_row != out_row) {
+                    continue;
+                }
+                if (used_rows & (1u << src_row)) {
+                    continue;
+                }
+                // A new band must not be one we've already used
+                unsigned band_rows = ((1u << Order) - 1) << (band * Order);
+                if (out_row % Order == 0 && (used_rows & band_rows)) {
+                    continue;
+                }
+
+                auto labels = relabel;
+                int next = label_row(cells, src_row, current_.col_map, labels, next_label,
+                                     &current_cells_[out_row * SIZE]);
+
+                if (!prefix_not_worse(out_row + 1)) {
+                    continue;
+                }
+                current_.row_map[out_row] = src_row;
+                search_rows(out_row + 1, labels, next, used_rows | (1u << src_row));
+            }
+        }
+    }
+
+    void record_leaf(const std::array<int, SIZE + 1>& relabel, int next_label) {
+        if (have_best_ && current_cells_ >= best_cells_) {
+            return;
+        }
+        best_ = current_;
+        best_cells_ = current_cells_;
+        have_best_ = true;
+
+        // Digits missing from the puzzle still need a label, so the
+        // transform can map a full solution
+        best_.relabel = relabel;
+        for (int digit = 1; digit <= SIZE; ++digit) {
+            if (best_.relabel[digit] == 0) {
+                best_.relabel[digit] = next_label++;
+            }
+        }
+    }
+};
+
+} // namespace
+
+template<int Order>
+BasicGridTransform<Order> canonical_transform(const BasicSudokuGrid<Order>& puzzle) {
+    return CanonicalSearch<Order>(puzzle).run();
+}
+
+template struct BasicGridTransform<3>;
+template struct BasicGridTransform<4>;
+template struct BasicGridTransform<5>;
+
+template BasicGridTransform<3> canonical_transform(const BasicSudokuGrid<3>&);
+template BasicGridTransform<4> canonical_transform(const BasicSudokuGrid<4>&);
+template BasicGridTransform<5> canonical_transform(const BasicSudokuGrid<5>&);
+
+} // namespace sudoku_ga
@@ -0,0 +1,200 @@
+#include "Checkpoint.hpp"
+#include "RandomUtils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace sudoku_ga {
+
+namespace {
+
+constexpr char MAGIC[4] = {'S', 'G', 'A', 'C'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+// A saved mt19937 is about 7 KB of text; anything much longer means the
+// file is damaged (and shouldn't get to size an allocation)
+constexpr uint32_t MAX_RNG_STATE = 64 * 1024;
+
+template<typename T>
+void write_value(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+void read_value(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+// One byte per cell, row by row
+template<int Order>
+void write_cells(std::ostream& out, const BasicSudokuGrid<Order>& grid) {
+    using Grid = BasicSudokuGrid<Order>;
+    char cells[Grid::NUM_CELLS];
+    for (int i = 0; i < Grid::NUM_CELLS; ++i) {
+        cells[i] = static_cast<char>(grid.get(i));
+    }
+    out.write(cells, Grid::NUM_CELLS);
+}
+
+bool is_probability(double value) {
+    return std::isfinite(value) && value >= 0.0 && value <= 1.0;
+}
+
+// Rates a real run could have saved (see AdaptiveRates)
+bool valid_rates(const AdaptiveRates::State& rates) {
+    return is_probability(rates.crossover_rate) && is_probability(rates.mutation_rate) &&
+           is_probability(rates.crossover_quality) && is_probability(rates.copy_quality) &&
+           rates.min_candidates >= 1 &&
+           rates.local_search_candidates >= rates.min_candidates &&
+           rates.local_search_candidates <= AdaptiveRates::MAX_LOCAL_SEARCH_CANDIDATES;
+}
+
+} // namespace
+
+template<int Order>
+void save_checkpoint(const std::string& path, const BasicSudokuGrid<Order>& puzzle,
+                     const BasicCheckpoint<Order>& checkpoint) {
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot write checkpoint: " + temp_path);
+        }
+
+        out.write(MAGIC, 4);
+        write_value(out, FORMAT_VERSION);
+        write_value(out, static_cast<uint32_t>(Order));
+
+        write_value(out, static_cast<int32_t>(checkpoint.generation));
+        write_value(out, checkpoint.elapsed_seconds);
+        write_value(out, checkpoint.rates);
+
+        write_value(out, static_cast<uint32_t>(checkpoint.rng_state.size()));
+        out.write(checkpoint.rng_state.data(), checkpoint.rng_state.size());
+
+        write_cells(out, puzzle);
+
+        write_value(out, static_cast<uint32_t>(checkpoint.individuals.size()));
+        for (const auto& individual : checkpoint.individuals) {
+            write_value(out, static_cast<int32_t>(individual.fitness()));
+            write_cells(out, individual.grid());
+        }
+
+        if (!out.flush()) {
+            throw std::runtime_error("Cannot write checkpoint: " + temp_path);
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace checkpoint: " + path);
+    }
+}
+
+template<int Order>
+BasicCheckpoint<Order> load_checkpoint(const std::string& path,
+                                       const BasicSudokuGrid<Order>& puzzle) {
+    using Grid = BasicSudokuGrid<Order>;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open checkpoint: " + path);
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint32_t order = 0;
+    in.read(magic, 4);
+    read_value(in, version);
+    read_value(in, order);
+    if (!in || std::memcmp(magic, MAGIC, 4) != 0 || version != FORMAT_VERSION) {
+        throw std::runtime_error("Not a checkpoint: " + path);
+    }
+    if (order != static_cast<uint32_t>(Order)) {
+        throw std::runtime_error("Checkpoint is for a different board size: " + path);
+    }
+
+    BasicCheckpoint<Order> checkpoint;
+    int32_t generation = 0;
+    read_value(in, generation);
+    read_value(in, checkpoint.elapsed_seconds);
+    read_value(in, checkpoint.rates);
+    checkpoint.generation = generation;
+
+    uint32_t rng_length = 0;
+    read_value(in, rng_length);
+    if (!in) {
+        throw std::runtime_error("Checkpoint is truncated: " + path);
+    }
+    if (generation < 0 || !std::isfinite(checkpoint.elapsed_seconds) ||
+        checkpoint.elapsed_seconds < 0.0) {
+        throw std::runtime_error("Checkpoint is corrupt (bad generation or time): " + path);
+    }
+    if (!valid_rates(checkpoint.rates)) {
+        throw std::runtime_error("Checkpoint is corrupt (bad rates): " + path);
+    }
+    if (rng_length > MAX_RNG_STATE) {
+        throw std::runtime_error("Checkpoint is corrupt (random state too long): " + path);
+    }
+    checkpoint.rng_state.resize(rng_length);
+    in.read(checkpoint.rng_state.data(), rng_length);
+    if (in && !RandomGenerator::valid_state(checkpoint.rng_state)) {
+        throw std::runtime_error("Checkpoint is corrupt (bad random state): " + path);
+    }
+
+    char cells[Grid::NUM_CELLS];
+    in.read(cells, Grid::NUM_CELLS);
+    for (int i = 0; i < Grid::NUM_CELLS && in; ++i) {
+        if (cells[i] != puzzle.get(i)) {
+            throw std::runtime_error("Checkpoint is for a different puzzle: " + path);
+        }
+    }
+
+    uint32_t count = 0;
+    read_value(in, count);
+    for (uint32_t n = 0; n < count; ++n) {
+        int32_t fitness = 0;
+        read_value(in, fitness);
+        in.read(cells, Grid::NUM_CELLS);
+        if (!in) {
+            break;
+        }
+
+        // Start from the puzzle so the fixed flags are right. Every cell
+        // must hold a digit 1..SIZE (scoring shifts by it; individuals are
+        // always complete) and the givens must be the puzzle's.
+        BasicChromosome<Order> individual(puzzle);
+        for (int i = 0; i < Grid::NUM_CELLS; ++i) {
+            int value = static_cast<unsigned char>(cells[i]);
+            if (value < 1 || value > Grid::SIZE || (puzzle.is_fixed(i) && value != puzzle.get(i))) {
+                throw std::runtime_error("Checkpoint is corrupt (bad individual): " + path);
+            }
+            individual.grid().set(i, value);
+        }
+
+        // The stored fitness has to agree with the grid too
+        individual.recalculate_fitness();
+        if (individual.fitness() != fitness) {
+            throw std::runtime_error("Checkpoint is corrupt (wrong fitness): " + path);
+        }
+        checkpoint.individuals.push_back(individual);
+    }
+
+    if (!in || checkpoint.individuals.empty()) {
+        throw std::runtime_error("Checkpoint is truncated: " + path);
+    }
+    return checkpoint;
+}
+
+template void save_checkpoint(const std::string&, const BasicSudokuGrid<3>&, const BasicCheckpoint<3>&);
+template void save_checkpoint(const std::string&, const BasicSudokuGrid<4>&, const BasicCheckpoint<4>&);
+template void save_checkpoint(const std::string&, const BasicSudokuGrid<5>&, const BasicCheckpoint<5>&);
+
+template BasicCheckpoint<3> load_checkpoint(const std::string&, const BasicSudokuGrid<3>&);
+template BasicCheckpoint<4> load_checkpoint(const std::string&, const BasicSudokuGrid<4>&);
+template BasicCheckpoint<5> load_checkpoint(const std::string&, const BasicSudokuGrid<5>&);
+
+} // namespace sudoku_ga
@@ -1,31 +1,35 @@
 #include "Chromosome.hpp"
 #include "RandomUtils.hpp"
+#include "ScratchArena.hpp"
 
 #include <algorithm>
-#include <bitset>
 
 namespace sudoku_ga {
 
 // Default constructor - empty grid
-Chromosome::Chromosome() 
+template<int Order>
+BasicChromosome<Order>::BasicChromosome() 
     : grid_()
     , cached_fitness_(0)
 {}
 
 // Create from a puzzle - copies the grid but doesn't fill empty cells yet
-Chromosome::Chromosome(const SudokuGrid& initial_puzzle)
+template<int Order>
+BasicChromosome<Order>::BasicChromosome(const Grid& initial_puzzle)
     : grid_(initial_puzzle)
     , cached_fitness_(0)
 {}
 
 // Copy constructor - duplicate the grid and fitness
-Chromosome::Chromosome(const Chromosome& other)
+template<int Order>
+BasicChromosome<Order>::BasicChromosome(const BasicChromosome& other)
     : grid_(other.grid_)
     , cached_fitness_(other.cached_fitness_)
 {}
 
 // Copy assignment
-Chromosome& Chromosome::operator=(const Chromosome& other) {
+template<int Order>
+BasicChromosome<Order>& BasicChromosome<Order>::operator=(const BasicChromosome& other) {
     if (this != &other) {
         grid_ = other.grid_;
         cached_fitness_ = other.cached_fitness_;
@@ -34,30 +38,27 @@ Chromosome& Chromosome::operator=(const Chromosome& other) {
 }
 
 // Update the cached fitness value by recalculating from the grid
-void Chromosome::recalculate_fitness() {
+template<int Order>
+void BasicChromosome<Order>::recalculate_fitness() {
     cached_fitness_ = grid_.get_total_score();
 }
 
-// Fill one 3x3 sub-block with the digits it's missing
+// Fill one sub-block with the digits it's missing
 // The digits are placed in random order to create diversity
-void Chromosome::fill_subblock_random(int subblock_index) {
-    auto [top, left] = SudokuGrid::subblock_top_left(subblock_index);
+template<int Order>
+void BasicChromosome<Order>::fill_subblock_random(int subblock_index) {
+    const auto& cells = Grid::Geometry::box_cells(subblock_index);
     
     // First, figure out which digits are already in the sub-block (the fixed ones)
-    std::bitset<10> present;  // present[d] = true if digit d is already there
-    for (int r = top; r < top + SudokuGrid::SUBBLOCK_SIZE; ++r) {
-        for (int c = left; c < left + SudokuGrid::SUBBLOCK_SIZE; ++c) {
-            int val = grid_.get(r, c);
-            if (val != 0) {
-                present[val] = true;
-            }
-        }
+    typename Grid::DigitMask present = 0;  // bit d set if digit d is already there
+    for (int cell : cells) {
+        present |= typename Grid::DigitMask{1} << grid_.get(cell);
     }
     
     // Collect the digits that are missing (need to be filled in)
-    std::vector<int> missing;
-    for (int d = 1; d <= 9; ++d) {
-        if (!present[d]) {
+    std::pmr::vector<int> missing(scratch_memory());
+    for (int d = 1; d <= Grid::SIZE; ++d) {
+        if (!(present >> d & 1)) {
             missing.push_back(d);
         }
     }
@@ -67,28 +68,29 @@ void Chromosome::fill_subblock_random(int subblock_index) {
     
     // Place the shuffled digits into the empty cells
     size_t idx = 0;
-    for (int r = top; r < top + SudokuGrid::SUBBLOCK_SIZE; ++r) {
-        for (int c = left; c < left + SudokuGrid::SUBBLOCK_SIZE; ++c) {
-            if (grid_.get(r, c) == 0) {
-                grid_.set(r, c, missing[idx++]);
-            }
+    for (int cell : cells) {
+        if (grid_.get(cell) == 0) {
+            grid_.set(cell, missing[idx++]);
         }
     }
 }
 
 // Initialize all empty cells in the grid
-// After this, every sub-block will contain digits 1-9 exactly once
-void Chromosome::initialize_random() {
-    for (int block = 0; block < SudokuGrid::NUM_SUBBLOCKS; ++block) {
+// After this, every sub-block will contain each digit exactly once
+template<int Order>
+void BasicChromosome<Order>::initialize_random() {
+    for (int block = 0; block < Grid::NUM_SUBBLOCKS; ++block) {
         fill_subblock_random(block);
     }
     recalculate_fitness();
 }
 
 // Print the chromosome (grid + fitness info)
-std::ostream& operator<<(std::ostream& os, const Chromosome& chrom) {
-    os << chrom.grid_;
-    os << "Fitness: " << chrom.fitness() << " / " << SudokuGrid::MAX_SCORE;
+template<int Order>
+std::ostream& operator<<(std::ostream& os, const BasicChromosome<Order>& chrom) {
+    using Grid = BasicSudokuGrid<Order>;
+    os << chrom.grid();
+    os << "Fitness: " << chrom.fitness() << " / " << Grid::MAX_SCORE;
     if (chrom.is_solution()) {
         os << " [SOLVED]";
     }
@@ -96,6 +98,12 @@ std::ostream& operator<<(std::ostream& os, const Chromosome& chrom) {
     return os;
 }
 
-} // namespace sudoku_ga
+template class BasicChromosome<3>;
+template class BasicChromosome<4>;
+template class BasicChromosome<5>;
 
+template std::ostream& operator<<(std::ostream&, const BasicChromosome<3>&);
+template std::ostream& operator<<(std::ostream&, const BasicChromosome<4>&);
+template std::ostream& operator<<(std::ostream&, const BasicChromosome<5>&);
 
+} // namespace sudoku_ga
@@ -0,0 +1,247 @@
+#include "Difficulty.hpp"
+
+#include <array>
+
+namespace sudoku_ga {
+
+namespace {
+
+/*
+ * Candidate bookkeeping for propagation
+ *
+ * For each row, column and sub-block we keep a mask of the digits already
+ * placed there (bit d-1 for digit d). A cell's candidates are the digits
+ * missing from all three of its units.
+ */
+template<int Order>
+class Propagator {
+public:
+    using Grid = BasicSudokuGrid<Order>;
+    using Mask = typename Grid::DigitMask;
+
+    static constexpr int SIZE = Grid::SIZE;
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((Mask{1} << (SIZE - 1) << 1) - 1);
+
+    explicit Propagator(const Grid& puzzle) : grid_(puzzle) {
+        for (int row = 0; row < SIZE; ++row) {
+            for (int col = 0; col < SIZE; ++col) {
+                int value = grid_.get(row, col);
+                if (value == 0) {
+                    continue;
+                }
+                // A given that repeats in its row/column/sub-block
+                if (!(candidates(row, col) & (Mask{1} << (value - 1)))) {
+                    contradiction_ = true;
+                }
+                mark(row, col, value);
+            }
+        }
+    }
+
+    Grid& grid() { return grid_; }
+    bool contradiction() const { return contradiction_; }
+    int filled_by_naked() const { return filled_by_naked_; }
+    int filled_by_hidden() const { return filled_by_hidden_; }
+
+    Mask candidates(int row, int col) const {
+        return ALL_DIGITS & ~(row_used_[row] | col_used_[col] | block_used_[block_of(row, col)]);
+    }
+
+    // One pass of each technique; returns true if anything was placed
+    bool naked_singles();
+    bool hidden_singles();
+
+private:
+    Grid grid_;
+    std::array<Mask, SIZE> row_used_{};
+    std::array<Mask, SIZE> col_used_{};
+    std::array<Mask, SIZE> block_used_{};
+    bool contradiction_ = false;
+    int filled_by_naked_ = 0;
+    int filled_by_hidden_ = 0;
+
+    using Geometry = typename Grid::Geometry;
+
+    static int block_of(int row, int col) {
+        return Geometry::box_of(Grid::cell_index(row, col));
+    }
+
+    // Cell k of unit u: units 0..SIZE-1 are rows, then columns, then sub-blocks
+    static std::pair<int, int> unit_cell(int unit, int k) {
+        int index = unit % SIZE;
+        switch (unit / SIZE) {
+            case 0: return {index, k};
+            case 1: return {k, index};
+            default: {
+                int cell = Geometry::box_cells(index)[k];
+                return {Geometry::row_of(cell), Geometry::col_of(cell)};
+            }
+        }
+    }
+
+    void mark(int row, int col, int value) {
+        Mask bit = Mask{1} << (value - 1);
+        row_used_[row] |= bit;
+        col_used_[col] |= bit;
+        block_used_[block_of(row, col)] |= bit;
+    }
+
+    void place(int row, int col, int value) {
+        grid_.set_given(row, col, value);
+        mark(row, col, value);
+    }
+};
+
+template<int Order>
+bool Propagator<Order>::naked_singles() {
+    bool changed = false;
+    for (int row = 0; row < SIZE; ++row) {
+        for (int col = 0; col < SIZE; ++col) {
+            if (grid_.get(row, col) != 0) {
+                continue;
+            }
+            Mask mask = candidates(row, col);
+            if (mask == 0) {
+                contradiction_ = true;
+                return false;
+            }
+            if ((mask & (mask - 1)) == 0) {
+                place(row, col, __builtin_ctzll(mask) + 1);
+                ++filled_by_naked_;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+template<int Order>
+bool Propagator<Order>::hidden_singles() {
+    bool changed = false;
+    for (int unit = 0; unit < 3 * SIZE; ++unit) {
+        for (int digit = 1; digit <= SIZE; ++digit) {
+            Mask bit = Mask{1} << (digit - 1);
+            int places = 0;
+            std::pair<int, int> where{};
+            bool already_placed = false;
+
+            for (int k = 0; k < SIZE && !already_placed; ++k) {
+                auto [row, col] = unit_cell(unit, k);
+                int value = grid_.get(row, col);
+                if (value == digit) {
+                    already_placed = true;
+                } else if (value == 0 && (candidates(row, col) & bit)) {
+                    ++places;
+                    where = {row, col};
+                }
+            }
+
+            if (already_placed) {
+                continue;
+            }
+            if (places == 0) {
+                contradiction_ = true;
+                return false;
+            }
+            if (places == 1) {
+                place(where.first, where.second, digit);
+                ++filled_by_hidden_;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+// =============================================================================
+// Difficulty estimate
+// =============================================================================
+
+template<int Order>
+BasicDifficultyReport<Order> estimate_difficulty(const BasicSudokuGrid<Order>& puzzle) {
+    using Grid = BasicSudokuGrid<Order>;
+
+    BasicDifficultyReport<Order> report;
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            report.givens += puzzle.get(row, col) != 0;
+        }
+    }
+
+    // Naked singles first (cheapest); hidden singles only when they stall
+    Propagator<Order> propagator(puzzle);
+    bool needed_hidden = false;
+    while (!propagator.contradiction()) {
+        if (propagator.naked_singles()) {
+            continue;
+        }
+        if (propagator.contradiction() || !propagator.hidden_singles()) {
+            break;
+        }
+        needed_hidden = true;
+    }
+
+    if (propagator.contradiction()) {
+        report.contradiction = true;
+        report.hardest_technique = SolvingTechnique::Search;
+        report.level = DifficultyLevel::Extreme;
+        report.propagated = puzzle;
+        report.empty_after_propagation = Grid::NUM_CELLS - report.givens;
+        return report;
+    }
+
+    report.propagated = propagator.grid();
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            if (report.propagated.get(row, col) == 0) {
+                ++report.empty_after_propagation;
+                report.candidates_after_propagation +=
+                    __builtin_popcountll(propagator.candidates(row, col));
+            }
+        }
+    }
+
+    if (report.empty_after_propagation > 0) {
+        report.hardest_technique = SolvingTechnique::Search;
+        report.level = 2 * report.empty_after_propagation < Grid::NUM_CELLS
+            ? DifficultyLevel::Hard
+            : DifficultyLevel::Extreme;
+    } else if (needed_hidden) {
+        report.hardest_technique = SolvingTechnique::HiddenSingle;
+        report.level = DifficultyLevel::Medium;
+    } else {
+        report.hardest_technique = propagator.filled_by_naked() > 0
+            ? SolvingTechnique::NakedSingle
+            : SolvingTechnique::None;
+        report.level = DifficultyLevel::Easy;
+    }
+    return report;
+}
+
+const char* difficulty_level_name(DifficultyLevel level) {
+    switch (level) {
+        case DifficultyLevel::Easy: return "easy";
+        case DifficultyLevel::Medium: return "medium";
+        case DifficultyLevel::Hard: return "hard";
+        case DifficultyLevel::Extreme: return "extreme";
+    }
+    return "unknown";
+}
+
+const char* solving_technique_name(SolvingTechnique technique) {
+    switch (technique) {
+        case SolvingTechnique::None: return "none";
+        case SolvingTechnique::NakedSingle: return "naked single";
+        case SolvingTechnique::HiddenSingle: return "hidden single";
+        case SolvingTechnique::Search: return "search";
+    }
+    return "unknown";
+}
+
+template BasicDifficultyReport<3> estimate_difficulty(const BasicSudokuGrid<3>&);
+template BasicDifficultyReport<4> estimate_difficulty(const BasicSudokuGrid<4>&);
+template BasicDifficultyReport<5> estimate_difficulty(const BasicSudokuGrid<5>&);
+
+} // namespace sudoku_ga
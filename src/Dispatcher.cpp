@@ -0,0 +1,109 @@
+#include "Dispatcher.hpp"
+
+#include <chrono>
+
+namespace sudoku_ga {
+
+const char* engine_name(Engine engine) {
+    switch (engine) {
+        case Engine::Exact: return "exact";
+        case Engine::Genetic: return "genetic";
+        case Engine::Annealing: return "annealing";
+        case Engine::Tabu: return "tabu";
+    }
+    return "unknown";
+}
+
+template<int Order>
+BasicDispatcher<Order>::BasicDispatcher(const DispatchParams& params)
+    : params_(params)
+{}
+
+template<int Order>
+Engine BasicDispatcher<Order>::choose_engine(const Report& report) const {
+    if (report.contradiction) {
+        return Engine::Exact;   // Nothing to search for (see solve)
+    }
+    switch (report.level) {
+        case DifficultyLevel::Easy:
+        case DifficultyLevel::Medium:
+            return Engine::Exact;
+        case DifficultyLevel::Hard:
+            return params_.hard_engine;
+        case DifficultyLevel::Extreme:
+            break;
+    }
+    return params_.extreme_engine;
+}
+
+template<int Order>
+BasicSolverResult<Order> BasicDispatcher<Order>::exact_result(const Grid& propagated) {
+    Result result;
+    result.best_individual = Chromosome(propagated);
+    result.best_individual.recalculate_fitness();
+    result.best_fitness = result.best_individual.fitness();
+    result.solved = result.best_individual.is_solution();
+    return result;
+}
+
+template<int Order>
+BasicSolverResult<Order> BasicDispatcher<Order>::solve(const Grid& puzzle) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    Result result = solve(estimate_difficulty(puzzle));
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+    return result;
+}
+
+template<int Order>
+BasicSolverResult<Order> BasicDispatcher<Order>::solve(const Report& report) {
+    // Propagation proved the puzzle has no solution; searching would only
+    // burn the whole budget of an engine (seconds, for tabu). Give back
+    // the puzzle itself as an unsolved result.
+    if (report.contradiction) {
+        return exact_result(report.propagated);
+    }
+
+    Engine engine = choose_engine(report);
+
+    // An exact engine that can't finish (shouldn't happen unless the
+    // levels were changed) falls back to the extreme engine
+    if (engine == Engine::Exact) {
+        Result result = exact_result(report.propagated);
+        if (result.solved) {
+            return result;
+        }
+        engine = params_.extreme_engine;
+    }
+
+    const SolverParams& ga_params = report.level == DifficultyLevel::Hard
+        ? params_.hard_params
+        : params_.extreme_params;
+
+    switch (engine) {
+        case Engine::Annealing: {
+            BasicAnnealingSolver<Order> solver(params_.annealing_params);
+            solver.set_stop_condition(should_stop_);
+            return solver.solve(report.propagated);
+        }
+        case Engine::Tabu: {
+            BasicTabuSolver<Order> solver(params_.tabu_params);
+            solver.set_stop_condition(should_stop_);
+            return solver.solve(report.propagated);
+        }
+        case Engine::Genetic:
+        case Engine::Exact:
+            break;
+    }
+    BasicSolver<Order> solver(ga_params);
+    solver.set_stop_condition(should_stop_);
+    return solver.solve(report.propagated);
+}
+
+template class BasicDispatcher<3>;
+template class BasicDispatcher<4>;
+template class BasicDispatcher<5>;
+
+} // namespace sudoku_ga
@@ -0,0 +1,293 @@
+#include "FitnessKernels.hpp"
+#include "SudokuGrid.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SUDOKU_GA_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sudoku_ga {
+
+namespace {
+
+constexpr int N = SudokuGrid::SIZE;
+
+// ============================================================================
+// Scalar versions (always available)
+// ============================================================================
+
+int score_grid_scalar(const uint8_t* cells) {
+    int score = 0;
+    for (int i = 0; i < N; ++i) {
+        unsigned row_mask = 0;
+        unsigned col_mask = 0;
+        for (int j = 0; j < N; ++j) {
+            row_mask |= 1u << cells[i * N + j];
+            col_mask |= 1u << cells[j * N + i];
+        }
+        // Bit 0 is an empty cell, which doesn't count
+        score += __builtin_popcount(row_mask & ~1u);
+        score += __builtin_popcount(col_mask & ~1u);
+    }
+    return score;
+}
+
+void score_batch_scalar(const uint8_t* planes, size_t stride, size_t count, int* fitness_out) {
+    for (size_t g = 0; g < count; ++g) {
+        int score = 0;
+        for (int i = 0; i < N; ++i) {
+            unsigned row_mask = 0;
+            unsigned col_mask = 0;
+            for (int j = 0; j < N; ++j) {
+                row_mask |= 1u << planes[(i * N + j) * stride + g];
+                col_mask |= 1u << planes[(j * N + i) * stride + g];
+            }
+            score += __builtin_popcount(row_mask & ~1u);
+            score += __builtin_popcount(col_mask & ~1u);
+        }
+        fitness_out[g] = score;
+    }
+}
+
+#ifdef SUDOKU_GA_X86
+
+// ============================================================================
+// SSE4.1 (16 grids at a time)
+// ============================================================================
+
+// One-hot lookup tables for pshufb: digits 1-8 map to one bit of the "low"
+// byte, digit 9 to the "high" byte, 0 (empty) to nothing.
+#define SUDOKU_GA_ONEHOT_LO 0, 1, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0
+#define SUDOKU_GA_ONEHOT_HI 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0
+#define SUDOKU_GA_POPCOUNT4 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+
+__attribute__((target("sse4.1")))
+inline __m128i popcount8_sse(__m128i v) {
+    const __m128i lut = _mm_setr_epi8(SUDOKU_GA_POPCOUNT4);
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    __m128i lo = _mm_and_si128(v, low_nibble);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble);
+    return _mm_add_epi8(_mm_shuffle_epi8(lut, lo), _mm_shuffle_epi8(lut, hi));
+}
+
+// Distinct-digit count of one row or column (9 planes, step apart) for 16 grids
+__attribute__((target("sse4.1")))
+inline __m128i unit_score_sse(const uint8_t* first, size_t step) {
+    const __m128i lut_lo = _mm_setr_epi8(SUDOKU_GA_ONEHOT_LO);
+    const __m128i lut_hi = _mm_setr_epi8(SUDOKU_GA_ONEHOT_HI);
+    __m128i lo = _mm_setzero_si128();
+    __m128i hi = _mm_setzero_si128();
+    for (int k = 0; k < N; ++k) {
+        __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + k * step));
+        lo = _mm_or_si128(lo, _mm_shuffle_epi8(lut_lo, digits));
+        hi = _mm_or_si128(hi, _mm_shuffle_epi8(lut_hi, digits));
+    }
+    return _mm_add_epi8(popcount8_sse(lo), hi);
+}
+
+__attribute__((target("sse4.1")))
+void score_batch_sse41(const uint8_t* planes, size_t stride, size_t count, int* fitness_out) {
+    for (size_t g = 0; g < count; g += 16) {
+        // Max score is 162, so byte accumulators never overflow
+        __m128i total = _mm_setzero_si128();
+        for (int i = 0; i < N; ++i) {
+            total = _mm_add_epi8(total, unit_score_sse(planes + (i * N) * stride + g, stride));
+            total = _mm_add_epi8(total, unit_score_sse(planes + i * stride + g, N * stride));
+        }
+
+        // Widen the 16 byte scores to ints, 4 at a time
+        alignas(16) int out[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu8_epi32(total));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu8_epi32(_mm_srli_si128(total, 4)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + 8), _mm_cvtepu8_epi32(_mm_srli_si128(total, 8)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + 12), _mm_cvtepu8_epi32(_mm_srli_si128(total, 12)));
+        std::copy(out, out + std::min<size_t>(16, count - g), fitness_out + g);
+    }
+}
+
+// ============================================================================
+// AVX2 (32 grids at a time, or one grid with 8 columns per vector)
+// ============================================================================
+
+__attribute__((target("avx2")))
+inline __m256i popcount8_avx2(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(SUDOKU_GA_POPCOUNT4, SUDOKU_GA_POPCOUNT4);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(v, low_nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+}
+
+__attribute__((target("avx2")))
+inline __m256i unit_score_avx2(const uint8_t* first, size_t step) {
+    const __m256i lut_lo = _mm256_setr_epi8(SUDOKU_GA_ONEHOT_LO, SUDOKU_GA_ONEHOT_LO);
+    const __m256i lut_hi = _mm256_setr_epi8(SUDOKU_GA_ONEHOT_HI, SUDOKU_GA_ONEHOT_HI);
+    __m256i lo = _mm256_setzero_si256();
+    __m256i hi = _mm256_setzero_si256();
+    for (int k = 0; k < N; ++k) {
+        __m256i digits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + k * step));
+        lo = _mm256_or_si256(lo, _mm256_shuffle_epi8(lut_lo, digits));
+        hi = _mm256_or_si256(hi, _mm256_shuffle_epi8(lut_hi, digits));
+    }
+    return _mm256_add_epi8(popcount8_avx2(lo), hi);
+}
+
+__attribute__((target("avx2")))
+void score_batch_avx2(const uint8_t* planes, size_t stride, size_t count, int* fitness_out) {
+    for (size_t g = 0; g < count; g += 32) {
+        __m256i total = _mm256_setzero_si256();
+        for (int i = 0; i < N; ++i) {
+            total = _mm256_add_epi8(total, unit_score_avx2(planes + (i * N) * stride + g, stride));
+            total = _mm256_add_epi8(total, unit_score_avx2(planes + i * stride + g, N * stride));
+        }
+
+        // Widen the 32 byte scores to ints, 8 at a time
+        alignas(32) int out[32];
+        __m128i low = _mm256_castsi256_si128(total);
+        __m128i high = _mm256_extracti128_si256(total, 1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi32(low));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_cvtepu8_epi32(high));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+        std::copy(out, out + std::min<size_t>(32, count - g), fitness_out + g);
+    }
+}
+
+// One grid: each 8-lane vector holds the one-hot masks of columns 0-7 of a
+// row (its first 8 bytes, widened to ints). OR-ing rows together gives 8
+// column masks at once; column 8 (which doesn't fit in the vector) is
+// tracked with scalar code.
+__attribute__((target("avx2")))
+int score_grid_avx2(const uint8_t* cells) {
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i col_masks = _mm256_setzero_si256();
+    unsigned col8_mask = 0;
+    int score = 0;
+
+    for (int r = 0; r < N; ++r) {
+        const uint8_t* row = cells + r * N;
+        __m256i digits = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row)));
+        __m256i onehot = _mm256_sllv_epi32(one, digits);
+        col_masks = _mm256_or_si256(col_masks, onehot);
+
+        // Horizontal OR of the 8 one-hot lanes gives the row mask
+        __m128i m = _mm_or_si128(_mm256_castsi256_si128(onehot), _mm256_extracti128_si256(onehot, 1));
+        m = _mm_or_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_or_si128(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        unsigned last = 1u << row[N - 1];
+        unsigned row_mask = static_cast<unsigned>(_mm_cvtsi128_si32(m)) | last;
+        col8_mask |= last;
+        score += __builtin_popcount(row_mask & ~1u);
+    }
+
+    alignas(32) unsigned cols[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(cols), col_masks);
+    for (unsigned mask : cols) {
+        score += __builtin_popcount(mask & ~1u);
+    }
+    score += __builtin_popcount(col8_mask & ~1u);
+    return score;
+}
+
+#endif  // SUDOKU_GA_X86
+
+SimdLevel detect_simd_level() {
+#ifdef SUDOKU_GA_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+using ScoreGridFn = int (*)(const uint8_t*);
+using ScoreBatchFn = void (*)(const uint8_t*, size_t, size_t, int*);
+
+// The implementations to use at one level
+struct Dispatch {
+    ScoreGridFn grid = score_grid_scalar;
+    ScoreBatchFn batch = score_batch_scalar;
+
+    explicit Dispatch(SimdLevel level) {
+        if (!simd_level_supported(level)) {
+            throw std::invalid_argument(std::string("SIMD level not supported on this machine: ") +
+                                        simd_level_name(level));
+        }
+#ifdef SUDOKU_GA_X86
+        switch (level) {
+            case SimdLevel::AVX2:
+                grid = score_grid_avx2;
+                batch = score_batch_avx2;
+                break;
+            case SimdLevel::SSE41:
+                batch = score_batch_sse41;
+                break;
+            case SimdLevel::Scalar:
+                break;
+        }
+#endif
+    }
+};
+
+// Resolved once, on first use
+const Dispatch& dispatch() {
+    static const Dispatch table(simd_level());
+    return table;
+}
+
+} // namespace
+
+SimdLevel simd_level() {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        case SimdLevel::Scalar: return "scalar";
+    }
+    return "unknown";
+}
+
+bool simd_level_supported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+#ifdef SUDOKU_GA_X86
+        case SimdLevel::SSE41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1");
+        case SimdLevel::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+int score_grid(const uint8_t* cells) {
+    return dispatch().grid(cells);
+}
+
+void score_batch(const uint8_t* planes, size_t stride, size_t count, int* fitness_out) {
+    dispatch().batch(planes, stride, count, fitness_out);
+}
+
+int score_grid_at(SimdLevel level, const uint8_t* cells) {
+    return Dispatch(level).grid(cells);
+}
+
+void score_batch_at(SimdLevel level, const uint8_t* planes, size_t stride, size_t count, int* fitness_out) {
+    Dispatch(level).batch(planes, stride, count, fitness_out);
+}
+
+} // namespace sudoku_ga
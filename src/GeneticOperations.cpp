@@ -1,7 +1,9 @@
 #include "GeneticOperations.hpp"
 #include "RandomUtils.hpp"
+#include "ScratchArena.hpp"
 
 #include <algorithm>
+#include <tuple>
 
 namespace sudoku_ga {
 
@@ -9,74 +11,120 @@ namespace sudoku_ga {
 // CROSSOVER
 // ============================================================================
 
-std::pair<Chromosome, Chromosome> crossover(const Chromosome& parent1,
-                                             const Chromosome& parent2) {
-    // Start both children as copies of parent1
-    Chromosome child1(parent1);
-    Chromosome child2(parent1);
-    
-    // Child 1: for each band of 3 rows, pick whichever parent has better scores
-    for (int band = 0; band < 3; ++band) {
+// Build both children directly in their destination. Every band of child1
+// and every stack of child2 is copied exactly once, from the winning parent,
+// so the children's previous contents don't matter.
+template<int Order>
+void crossover_into(const BasicChromosome<Order>& parent1,
+                    const BasicChromosome<Order>& parent2,
+                    BasicChromosome<Order>& child1,
+                    BasicChromosome<Order>& child2) {
+    // Child 1: for each band of rows, pick whichever parent has better scores
+    for (int band = 0; band < Order; ++band) {
         int score1 = parent1.grid().get_row_band_score(band);
         int score2 = parent2.grid().get_row_band_score(band);
         
-        if (score2 > score1) {
-            // Parent 2 is better for this band - use their rows
-            child1.grid().copy_row_band_from(parent2.grid(), band);
-        }
-        // Otherwise we keep parent1's band (already there from the copy)
+        // Ties go to parent 1
+        const auto& winner = score2 > score1 ? parent2 : parent1;
+        child1.grid().copy_row_band_from(winner.grid(), band);
     }
     
     // Child 2: same idea, but with column stacks instead of row bands
-    for (int stack = 0; stack < 3; ++stack) {
+    for (int stack = 0; stack < Order; ++stack) {
         int score1 = parent1.grid().get_column_stack_score(stack);
         int score2 = parent2.grid().get_column_stack_score(stack);
         
-        if (score2 > score1) {
-            child2.grid().copy_column_stack_from(parent2.grid(), stack);
-        } else {
-            child2.grid().copy_column_stack_from(parent1.grid(), stack);
-        }
+        const auto& winner = score2 > score1 ? parent2 : parent1;
+        child2.grid().copy_column_stack_from(winner.grid(), stack);
     }
     
     // Update fitness for the new children
     child1.recalculate_fitness();
     child2.recalculate_fitness();
-    
-    return {std::move(child1), std::move(child2)};
+}
+
+template<int Order>
+std::pair<BasicChromosome<Order>, BasicChromosome<Order>> crossover(const BasicChromosome<Order>& parent1,
+                                                                    const BasicChromosome<Order>& parent2) {
+    std::pair<BasicChromosome<Order>, BasicChromosome<Order>> children;
+    crossover_into(parent1, parent2, children.first, children.second);
+    return children;
 }
 
 // ============================================================================
 // MUTATION
 // ============================================================================
 
-// Swap two random non-fixed cells within one sub-block
-void mutate_subblock(Chromosome& chrom, int subblock_index) {
+// Pick two different random non-fixed cells in one sub-block
+template<int Order>
+bool random_subblock_swap(const BasicSudokuGrid<Order>& grid, int subblock_index, CellSwap& swap) {
     // Get list of cells we're allowed to change
-    auto positions = chrom.grid().get_subblock_non_fixed_positions(subblock_index);
+    auto cells = grid.get_subblock_non_fixed_cells(subblock_index);
     
     // Need at least 2 cells to do a swap
-    if (positions.size() < 2) {
-        return;
+    if (cells.size() < 2) {
+        return false;
     }
     
-    // Pick two different random positions
-    auto [idx1, idx2] = rng().two_distinct_indices(static_cast<int>(positions.size()) - 1);
-    auto [r1, c1] = positions[idx1];
-    auto [r2, c2] = positions[idx2];
+    // Pick two different random cells
+    auto [idx1, idx2] = rng().two_distinct_indices(static_cast<int>(cells.size()) - 1);
+    swap.cell1 = cells[idx1];
+    swap.cell2 = cells[idx2];
+    return true;
+}
+
+// Score of the rows and columns a swap touches (each counted once)
+template<int Order>
+static int swap_region_score(const BasicSudokuGrid<Order>& grid, const CellSwap& swap) {
+    using Geometry = typename BasicSudokuGrid<Order>::Geometry;
+    
+    int row1 = Geometry::row_of(swap.cell1);
+    int col1 = Geometry::col_of(swap.cell1);
+    int row2 = Geometry::row_of(swap.cell2);
+    int col2 = Geometry::col_of(swap.cell2);
     
-    // Do the swap
-    int temp = chrom.grid().get(r1, c1);
-    chrom.grid().set(r1, c1, chrom.grid().get(r2, c2));
-    chrom.grid().set(r2, c2, temp);
+    int score = grid.get_row_score(row1) + grid.get_column_score(col1);
+    if (row2 != row1) {
+        score += grid.get_row_score(row2);
+    }
+    if (col2 != col1) {
+        score += grid.get_column_score(col2);
+    }
+    return score;
+}
+
+template<int Order>
+void swap_cells(BasicSudokuGrid<Order>& grid, const CellSwap& swap) {
+    int temp = grid.get(swap.cell1);
+    grid.set(swap.cell1, grid.get(swap.cell2));
+    grid.set(swap.cell2, temp);
+}
+
+// Swap the two cells and report the fitness change. Everything outside the
+// touched rows and columns is unchanged, so that's all we need to re-score.
+template<int Order>
+int apply_swap(BasicSudokuGrid<Order>& grid, const CellSwap& swap) {
+    int before = swap_region_score(grid, swap);
+    swap_cells(grid, swap);
+    return swap_region_score(grid, swap) - before;
+}
+
+// Swap two random non-fixed cells within one sub-block
+template<int Order>
+void mutate_subblock(BasicChromosome<Order>& chrom, int subblock_index) {
+    CellSwap swap;
+    if (random_subblock_swap(chrom.grid(), subblock_index, swap)) {
+        swap_cells(chrom.grid(), swap);
+    }
 }
 
 // Apply mutation to each sub-block with the given probability
-void mutate(Chromosome& chrom, double mutation_rate) {
+template<int Order>
+void mutate(BasicChromosome<Order>& chrom, double mutation_rate) {
     bool mutated = false;
     
-    // Go through all 9 sub-blocks
-    for (int block = 0; block < SudokuGrid::NUM_SUBBLOCKS; ++block) {
+    // Go through all sub-blocks
+    for (int block = 0; block < BasicSudokuGrid<Order>::NUM_SUBBLOCKS; ++block) {
         // Roll the dice - should we mutate this block?
         if (rng().rand_double() < mutation_rate) {
             mutate_subblock(chrom, block);
@@ -91,32 +139,215 @@ void mutate(Chromosome& chrom, double mutation_rate) {
 }
 
 
+// ============================================================================
+// CONFLICT-DIRECTED MUTATION
+// ============================================================================
+
+template<int Order>
+ConflictTracker<Order>::ConflictTracker(const Grid& grid) {
+    for (int cell = 0; cell < Grid::NUM_CELLS; ++cell) {
+        int digit = grid.get(cell);
+        ++row_counts_[Geometry::row_of(cell)][digit];
+        ++col_counts_[Geometry::col_of(cell)][digit];
+    }
+}
+
+// A row or column scores one point per distinct digit, so the score only
+// changes when a count drops to 0 or rises from 0 (empty cells don't count)
+template<int Order>
+void ConflictTracker<Order>::move_digit(int cell, int from, int to) {
+    int row = Geometry::row_of(cell);
+    int col = Geometry::col_of(cell);
+    if (--row_counts_[row][from] == 0 && from != 0) --score_change_;
+    if (--col_counts_[col][from] == 0 && from != 0) --score_change_;
+    if (row_counts_[row][to]++ == 0 && to != 0) ++score_change_;
+    if (col_counts_[col][to]++ == 0 && to != 0) ++score_change_;
+}
+
+template<int Order>
+void ConflictTracker<Order>::apply(Grid& grid, const CellSwap& swap) {
+    int digit1 = grid.get(swap.cell1);
+    int digit2 = grid.get(swap.cell2);
+    move_digit(swap.cell1, digit1, digit2);
+    move_digit(swap.cell2, digit2, digit1);
+    swap_cells(grid, swap);
+}
+
+// Like mutate(), but only swaps cells that are actually in conflict
+template<int Order>
+void mutate_conflicts(BasicChromosome<Order>& chrom, double mutation_rate) {
+    auto& grid = chrom.grid();
+    ConflictTracker<Order> tracker(grid);
+    
+    std::pmr::vector<int> conflicting(scratch_memory());
+    std::pmr::vector<int> others(scratch_memory());
+    
+    for (int block = 0; block < BasicSudokuGrid<Order>::NUM_SUBBLOCKS; ++block) {
+        if (rng().rand_double() >= mutation_rate) {
+            continue;
+        }
+        
+        // Split the cells we may change by whether they're in conflict
+        conflicting.clear();
+        others.clear();
+        for (int cell : grid.get_subblock_non_fixed_cells(block)) {
+            if (tracker.conflicts(grid, cell) > 0) {
+                conflicting.push_back(cell);
+            } else {
+                others.push_back(cell);
+            }
+        }
+        
+        // Nothing wrong here (or nothing we could swap it with)
+        if (conflicting.empty() || conflicting.size() + others.size() < 2) {
+            continue;
+        }
+        
+        // First cell: a conflicting one. Second: another conflicting one if
+        // there is one, otherwise any other free cell.
+        int first;
+        int second;
+        if (conflicting.size() >= 2) {
+            auto [i, j] = rng().two_distinct_indices(static_cast<int>(conflicting.size()) - 1);
+            first = conflicting[i];
+            second = conflicting[j];
+        } else {
+            first = conflicting[0];
+            second = others[rng().rand_int(0, static_cast<int>(others.size()) - 1)];
+        }
+        
+        tracker.apply(grid, CellSwap{first, second});
+    }
+    
+    chrom.set_fitness(chrom.fitness() + tracker.score_change());
+}
+
 // ============================================================================
 // LOCAL SEARCH (hill climbing)
 // ============================================================================
 
-// Try a few random mutations and keep the best result
-Chromosome local_search(const Chromosome& parent, int num_candidates) {
-    Chromosome best = parent;
-    int best_fitness = parent.fitness();
+// Try a few random swaps on the chromosome itself, keeping each one only
+// if it improves the fitness. A rejected swap is undone by swapping back,
+// so no copies are made and only the touched rows/columns are re-scored.
+template<int Order>
+void local_search(BasicChromosome<Order>& chrom, int num_candidates) {
+    int fitness = chrom.fitness();
     
     for (int i = 0; i < num_candidates; ++i) {
-        // Make a copy and mutate a random sub-block
-        Chromosome candidate = parent;
-        int block = rng().rand_int(0, SudokuGrid::NUM_SUBBLOCKS - 1);
-        mutate_subblock(candidate, block);
-        candidate.recalculate_fitness();
+        int block = rng().rand_int(0, BasicSudokuGrid<Order>::NUM_SUBBLOCKS - 1);
+        CellSwap swap;
+        if (!random_subblock_swap(chrom.grid(), block, swap)) {
+            continue;
+        }
         
-        // Keep it if it's better
+        int delta = apply_swap(chrom.grid(), swap);
+        if (delta > 0) {
+            // Keep it - it's better
+            fitness += delta;
+        } else {
+            // Undo (swapping the same two cells back)
+            swap_cells(chrom.grid(), swap);
+        }
+    }
+    
+    chrom.set_fitness(fitness);
+}
 
-        if (candidate.fitness() > best_fitness) {
-            best = std::move(candidate);
-            best_fitness = best.fitness();
+// Look at every legal swap in the given sub-blocks. Each candidate is
+// applied, scored by its delta and swapped back, so nothing is copied.
+template<int Order>
+static bool scan_swaps(BasicChromosome<Order>& chrom, int first_block, int last_block,
+                       bool first_improvement) {
+    auto& grid = chrom.grid();
+    CellSwap best_swap{};
+    int best_delta = 0;
+    
+    for (int block = first_block; block <= last_block; ++block) {
+        auto cells = grid.get_subblock_non_fixed_cells(block);
+        
+        for (size_t i = 0; i < cells.size(); ++i) {
+            for (size_t j = i + 1; j < cells.size(); ++j) {
+                CellSwap swap{cells[i], cells[j]};
+                int delta = apply_swap(grid, swap);
+                
+                if (delta > 0 && first_improvement) {
+                    // Keep it right away
+                    chrom.set_fitness(chrom.fitness() + delta);
+                    return true;
+                }
+                swap_cells(grid, swap);
+                
+                if (delta > best_delta) {
+                    best_delta = delta;
+                    best_swap = swap;
+                }
+            }
         }
     }
     
+    if (best_delta <= 0) {
+        return false;
+    }
+    swap_cells(grid, best_swap);
+    chrom.set_fitness(chrom.fitness() + best_delta);
+    return true;
+}
 
-    return best;
+template<int Order>
+bool improve_by_swap(BasicChromosome<Order>& chrom, int subblock_index, bool first_improvement) {
+    if (subblock_index >= 0) {
+        return scan_swaps(chrom, subblock_index, subblock_index, first_improvement);
+    }
+    return scan_swaps(chrom, 0, BasicSudokuGrid<Order>::NUM_SUBBLOCKS - 1, first_improvement);
+}
+
+// Run num_steps rounds of the chosen strategy
+template<int Order>
+void local_search(BasicChromosome<Order>& chrom, LocalSearchStrategy strategy,
+                  int num_steps, bool whole_grid) {
+    if (strategy == LocalSearchStrategy::Random) {
+        local_search(chrom, num_steps);
+        return;
+    }
+    
+    bool first_improvement = strategy == LocalSearchStrategy::FirstImprovement;
+    for (int step = 0; step < num_steps; ++step) {
+        if (whole_grid) {
+            // Nothing improves anywhere: we're at a local optimum, stop
+            if (!improve_by_swap(chrom, -1, first_improvement)) {
+                break;
+            }
+        } else {
+            int block = rng().rand_int(0, BasicSudokuGrid<Order>::NUM_SUBBLOCKS - 1);
+            improve_by_swap(chrom, block, first_improvement);
+        }
+    }
 }
 
+// ============================================================================
+// Instantiations for the supported board sizes
+// ============================================================================
+
+#define SUDOKU_GA_INSTANTIATE_OPERATIONS(ORDER)                                              \
+    template void crossover_into(const BasicChromosome<ORDER>&, const BasicChromosome<ORDER>&, \
+                                 BasicChromosome<ORDER>&, BasicChromosome<ORDER>&);         \
+    template std::pair<BasicChromosome<ORDER>, BasicChromosome<ORDER>>                      \
+    crossover(const BasicChromosome<ORDER>&, const BasicChromosome<ORDER>&);                \
+    template void mutate(BasicChromosome<ORDER>&, double);                                  \
+    template void mutate_subblock(BasicChromosome<ORDER>&, int);                            \
+    template bool random_subblock_swap(const BasicSudokuGrid<ORDER>&, int, CellSwap&);       \
+    template void swap_cells(BasicSudokuGrid<ORDER>&, const CellSwap&);                     \
+    template int apply_swap(BasicSudokuGrid<ORDER>&, const CellSwap&);                      \
+    template class ConflictTracker<ORDER>;                                                  \
+    template void mutate_conflicts(BasicChromosome<ORDER>&, double);                        \
+    template void local_search(BasicChromosome<ORDER>&, int);                               \
+    template bool improve_by_swap(BasicChromosome<ORDER>&, int, bool);                      \
+    template void local_search(BasicChromosome<ORDER>&, LocalSearchStrategy, int, bool);
+
+SUDOKU_GA_INSTANTIATE_OPERATIONS(3)
+SUDOKU_GA_INSTANTIATE_OPERATIONS(4)
+SUDOKU_GA_INSTANTIATE_OPERATIONS(5)
+
+#undef SUDOKU_GA_INSTANTIATE_OPERATIONS
+
 } // namespace sudoku_ga
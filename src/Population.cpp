@@ -3,15 +3,16 @@
 
 #include <algorithm>
 #include <limits>
-#include <numeric>
 #include <stdexcept>
 
 namespace sudoku_ga {
 
-Population::Population() = default;
+template<int Order>
+BasicPopulation<Order>::BasicPopulation() = default;
 
 // Create N chromosomes from the same puzzle, each with different random fills
-Population::Population(const SudokuGrid& puzzle, int size) {
+template<int Order>
+BasicPopulation<Order>::BasicPopulation(const Grid& puzzle, int size) {
     individuals_.reserve(size);
     
     for (int i = 0; i < size; ++i) {
@@ -19,48 +20,31 @@ Population::Population(const SudokuGrid& puzzle, int size) {
         chrom.initialize_random();  // Fill empty cells randomly
         individuals_.push_back(std::move(chrom));
     }
+    update_statistics();
 }
 
 // Find the chromosome with the highest fitness
-const Chromosome& Population::get_best() const {
+template<int Order>
+const BasicChromosome<Order>& BasicPopulation<Order>::get_best() const {
     if (individuals_.empty()) {
         throw std::runtime_error("Population is empty");
     }
-    
-    // std::max_element returns an iterator to the largest element
-    // We provide a custom comparator that compares by fitness
-    return *std::max_element(individuals_.begin(), individuals_.end(),
-        [](const Chromosome& a, const Chromosome& b) {
-            return a.fitness() < b.fitness();
-        });
-}
-
-Chromosome& Population::get_best() {
-    if (individuals_.empty()) {
-        throw std::runtime_error("Population is empty");
-    }
-    
-    return *std::max_element(individuals_.begin(), individuals_.end(),
-        [](const Chromosome& a, const Chromosome& b) {
-            return a.fitness() < b.fitness();
-        });
+    return individuals_[best_index_];
 }
 
 // Find the chromosome with the lowest fitness
-const Chromosome& Population::get_worst() const {
+template<int Order>
+const BasicChromosome<Order>& BasicPopulation<Order>::get_worst() const {
     if (individuals_.empty()) {
         throw std::runtime_error("Population is empty");
     }
-    
-    return *std::min_element(individuals_.begin(), individuals_.end(),
-        [](const Chromosome& a, const Chromosome& b) {
-            return a.fitness() < b.fitness();
-        });
+    return individuals_[worst_index_];
 }
 
 // Tournament selection: pick a few random individuals, return the fittest
 // This gives fitter individuals a better chance of being selected as parents
-Chromosome& Population::tournament_select(int tournament_size) {
+template<int Order>
+const BasicChromosome<Order>& BasicPopulation<Order>::tournament_select(int tournament_size) const {
     if (individuals_.empty()) {
         throw std::runtime_error("Population is empty");
     }
@@ -84,16 +68,18 @@ Chromosome& Population::tournament_select(int tournament_size) {
 }
 
 // Select two different parents for crossover
-std::pair<Chromosome*, Chromosome*> Population::select_parents(int tournament_size) {
+template<int Order>
+std::pair<const BasicChromosome<Order>*, const BasicChromosome<Order>*>
+BasicPopulation<Order>::select_parents(int tournament_size) const {
     if (individuals_.size() < 2) {
         throw std::runtime_error("Population must have at least 2 individuals");
     }
     
     // Pick first parent
-    Chromosome* parent1 = &tournament_select(tournament_size);
+    const Chromosome* parent1 = &tournament_select(tournament_size);
     
     // Pick second parent, making sure it's different
-    Chromosome* parent2 = nullptr;
+    const Chromosome* parent2 = nullptr;
     int max_attempts = 10;
     for (int attempt = 0; attempt < max_attempts; ++attempt) {
         parent2 = &tournament_select(tournament_size);
@@ -116,47 +102,76 @@ std::pair<Chromosome*, Chromosome*> Population::select_parents(int tournament_si
 }
 
 // Replace the entire population with a new generation
-void Population::replace_generation(std::vector<Chromosome> new_generation) {
+template<int Order>
+void BasicPopulation<Order>::replace_generation(std::vector<Chromosome> new_generation) {
     individuals_ = std::move(new_generation);
+    update_statistics();
 }
 
-int Population::best_fitness() const {
+template<int Order>
+void BasicPopulation<Order>::swap_generation(std::vector<Chromosome>& new_generation) {
+    individuals_.swap(new_generation);
+    update_statistics();
+}
+
+// One pass over the population collects everything the solver asks for
+// each generation: best/worst index, fitness sum and solution presence.
+// Ties keep the first index, matching std::max_element/std::min_element.
+template<int Order>
+void BasicPopulation<Order>::update_statistics() {
+    best_index_ = 0;
+    worst_index_ = 0;
+    fitness_sum_ = 0;
+    has_solution_ = false;
+
+    for (size_t i = 0; i < individuals_.size(); ++i) {
+        int fit = individuals_[i].fitness();
+        fitness_sum_ += fit;
+        if (fit > individuals_[best_index_].fitness()) {
+            best_index_ = i;
+        }
+        if (fit < individuals_[worst_index_].fitness()) {
+            worst_index_ = i;
+        }
+    }
+
+    // A solution is by definition the best individual
+    has_solution_ = !individuals_.empty() && individuals_[best_index_].is_solution();
+}
+
+template<int Order>
+int BasicPopulation<Order>::best_fitness() const {
     if (individuals_.empty()) return 0;
-    return get_best().fitness();
+    return individuals_[best_index_].fitness();
 }
 
-int Population::worst_fitness() const {
+template<int Order>
+int BasicPopulation<Order>::worst_fitness() const {
     if (individuals_.empty()) return 0;
-    return get_worst().fitness();
+    return individuals_[worst_index_].fitness();
 }
 
-// Calculate the mean fitness across all individuals
-double Population::average_fitness() const {
+// Mean fitness across all individuals (from the cached sum)
+template<int Order>
+double BasicPopulation<Order>::average_fitness() const {
     if (individuals_.empty()) return 0.0;
-    
-    // std::accumulate adds up all the fitness values
-    double sum = std::accumulate(individuals_.begin(), individuals_.end(), 0.0,
-        [](double acc, const Chromosome& c) {
-            return acc + c.fitness();
-        });
-    
-    return sum / individuals_.size();
+    return static_cast<double>(fitness_sum_) / individuals_.size();
 }
 
 // Check if any chromosome has a perfect score
-bool Population::has_solution() const {
-    return std::any_of(individuals_.begin(), individuals_.end(),
-        [](const Chromosome& c) { return c.is_solution(); });
+template<int Order>
+bool BasicPopulation<Order>::has_solution() const {
+    return has_solution_;
 }
 
 // Return a pointer to a solved chromosome, or nullptr if none exists
-const Chromosome* Population::get_solution() const {
-    for (const auto& ind : individuals_) {
-        if (ind.is_solution()) {
-            return &ind;
-        }
-    }
-    return nullptr;
+template<int Order>
+const BasicChromosome<Order>* BasicPopulation<Order>::get_solution() const {
+    return has_solution_ ? &individuals_[best_index_] : nullptr;
 }
 
+template class BasicPopulation<3>;
+template class BasicPopulation<4>;
+template class BasicPopulation<5>;
+
 } // namespace sudoku_ga
@@ -0,0 +1,217 @@
+#include "PopulationSoA.hpp"
+#include "FitnessKernels.hpp"
+#include "RandomUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sudoku_ga {
+
+// ============================================================================
+// ChromosomeView
+// ============================================================================
+
+// Score rows and columns straight from the planes, without building a grid.
+// Each row/column gets a bitmask of the digits it contains; the score is the
+// number of bits set.
+template<int Order>
+void BasicChromosomeView<Order>::recalculate_fitness() {
+    using DigitMask = typename Grid::DigitMask;
+    int score = 0;
+    for (int i = 0; i < Grid::SIZE; ++i) {
+        DigitMask row_mask = 0;
+        DigitMask col_mask = 0;
+        for (int j = 0; j < Grid::SIZE; ++j) {
+            row_mask |= DigitMask{1} << get(i, j);
+            col_mask |= DigitMask{1} << get(j, i);
+        }
+        // Bit 0 is an empty cell, which doesn't count
+        score += __builtin_popcountll(row_mask & ~DigitMask{1});
+        score += __builtin_popcountll(col_mask & ~DigitMask{1});
+    }
+    set_fitness(score);
+}
+
+template<int Order>
+void BasicChromosomeView<Order>::load_from(const Chromosome& chrom) {
+    for (int cell = 0; cell < Grid::NUM_CELLS; ++cell) {
+        population_->cell_plane(cell)[index_] = static_cast<uint8_t>(chrom.grid().get(cell));
+    }
+    set_fitness(chrom.fitness());
+}
+
+template<int Order>
+void BasicChromosomeView<Order>::store_to(Chromosome& chrom) const {
+    population_->store_individual(index_, chrom);
+}
+
+// ============================================================================
+// PopulationSoA
+// ============================================================================
+
+template<int Order>
+BasicPopulationSoA<Order>::BasicPopulationSoA() = default;
+
+template<int Order>
+BasicPopulationSoA<Order> BasicPopulationSoA<Order>::with_size(const Grid& puzzle, size_t size) {
+    BasicPopulationSoA pop;
+    pop.puzzle_ = puzzle;
+    pop.size_ = size;
+    pop.stride_ = (size + LANE_PADDING - 1) / LANE_PADDING * LANE_PADDING;
+    pop.cells_.assign(NUM_CELLS * pop.stride_, 0);
+    pop.fitness_.assign(size, 0);
+    return pop;
+}
+
+// Create N random individuals, each filled the same way as in Population
+template<int Order>
+BasicPopulationSoA<Order>::BasicPopulationSoA(const Grid& puzzle, int size)
+    : BasicPopulationSoA(with_size(puzzle, static_cast<size_t>(size)))
+{
+    for (size_t i = 0; i < size_; ++i) {
+        Chromosome chrom(puzzle);
+        chrom.initialize_random();
+        (*this)[i].load_from(chrom);
+    }
+    update_statistics();
+}
+
+template<int Order>
+void BasicPopulationSoA<Order>::load_from(const Population& population) {
+    if (population.empty()) {
+        *this = BasicPopulationSoA();
+        return;
+    }
+    // Every individual has the same fixed cells, so any of them can stand
+    // in for the puzzle
+    *this = with_size(population[0].grid(), population.size());
+
+    for (size_t i = 0; i < size_; ++i) {
+        (*this)[i].load_from(population[i]);
+    }
+    update_statistics();
+}
+
+template<int Order>
+BasicChromosome<Order> BasicPopulationSoA<Order>::to_chromosome(size_t index) const {
+    Chromosome chrom;
+    store_individual(index, chrom);
+    return chrom;
+}
+
+template<int Order>
+void BasicPopulationSoA<Order>::store_individual(size_t index, Chromosome& chrom) const {
+    // Start from the puzzle so the fixed flags are right, then fill in digits
+    chrom.grid() = puzzle_;
+    for (int cell = 0; cell < Grid::NUM_CELLS; ++cell) {
+        chrom.grid().set(cell, cell_plane(cell)[index]);
+    }
+    chrom.set_fitness(fitness_[index]);
+}
+
+template<int Order>
+void BasicPopulationSoA<Order>::copy_individual(size_t dest, const BasicPopulationSoA& source, size_t src) {
+    for (int k = 0; k < NUM_CELLS; ++k) {
+        cell_plane(k)[dest] = source.cell_plane(k)[src];
+    }
+    fitness_[dest] = source.fitness_[src];
+}
+
+// All individuals at once, straight from the planes (see FitnessKernels.hpp;
+// the batch kernels are 9x9 only, larger boards are scored one by one)
+template<int Order>
+void BasicPopulationSoA<Order>::evaluate_all() {
+    if constexpr (Order == 3) {
+        score_batch(cells_.data(), stride_, size_, fitness_.data());
+    } else {
+        for (size_t i = 0; i < size_; ++i) {
+            (*this)[i].recalculate_fitness();
+        }
+    }
+}
+
+// Tournament selection over the fitness array only
+template<int Order>
+size_t BasicPopulationSoA<Order>::tournament_select(int tournament_size) const {
+    if (size_ == 0) {
+        throw std::runtime_error("Population is empty");
+    }
+
+    tournament_size = std::min(tournament_size, static_cast<int>(size_));
+    tournament_size = std::max(tournament_size, 1);
+
+    auto indices = rng().sample_indices(static_cast<int>(size_), tournament_size);
+
+    int best_idx = indices[0];
+    for (int idx : indices) {
+        if (fitness_[idx] > fitness_[best_idx]) {
+            best_idx = idx;
+        }
+    }
+    return static_cast<size_t>(best_idx);
+}
+
+// Select two different parents, same rules as Population::select_parents
+template<int Order>
+std::pair<size_t, size_t> BasicPopulationSoA<Order>::select_parents(int tournament_size) const {
+    if (size_ < 2) {
+        throw std::runtime_error("Population must have at least 2 individuals");
+    }
+
+    size_t parent1 = tournament_select(tournament_size);
+    size_t parent2 = parent1;
+    int max_attempts = 10;
+    for (int attempt = 0; attempt < max_attempts && parent2 == parent1; ++attempt) {
+        parent2 = tournament_select(tournament_size);
+    }
+
+    // Fallback: just take a neighbour
+    if (parent2 == parent1) {
+        parent2 = (parent1 + 1) % size_;
+    }
+    return {parent1, parent2};
+}
+
+// One pass over the dense fitness array
+template<int Order>
+void BasicPopulationSoA<Order>::update_statistics() {
+    best_index_ = 0;
+    worst_index_ = 0;
+    fitness_sum_ = 0;
+
+    for (size_t i = 0; i < size_; ++i) {
+        fitness_sum_ += fitness_[i];
+        if (fitness_[i] > fitness_[best_index_]) {
+            best_index_ = i;
+        }
+        if (fitness_[i] < fitness_[worst_index_]) {
+            worst_index_ = i;
+        }
+    }
+    has_solution_ = size_ > 0 && fitness_[best_index_] == Grid::MAX_SCORE;
+}
+
+template<int Order>
+int BasicPopulationSoA<Order>::best_fitness() const {
+    return size_ == 0 ? 0 : fitness_[best_index_];
+}
+
+template<int Order>
+int BasicPopulationSoA<Order>::worst_fitness() const {
+    return size_ == 0 ? 0 : fitness_[worst_index_];
+}
+
+template<int Order>
+double BasicPopulationSoA<Order>::average_fitness() const {
+    if (size_ == 0) return 0.0;
+    return static_cast<double>(fitness_sum_) / size_;
+}
+
+template class BasicChromosomeView<3>;
+template class BasicChromosomeView<4>;
+template class BasicChromosomeView<5>;
+template class BasicPopulationSoA<3>;
+template class BasicPopulationSoA<4>;
+template class BasicPopulationSoA<5>;
+
+} // namespace sudoku_ga
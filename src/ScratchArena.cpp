@@ -0,0 +1,56 @@
+#include "ScratchArena.hpp"
+
+namespace sudoku_ga {
+
+namespace {
+
+// Size of the first buffer; it grows if a generation needs more
+constexpr size_t INITIAL_BUFFER_BYTES = 64 * 1024;
+
+} // namespace
+
+void* ScratchArena::Overflow::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void ScratchArena::Overflow::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+bool ScratchArena::Overflow::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+ScratchArena::ScratchArena()
+    : buffer_(new std::byte[INITIAL_BUFFER_BYTES])
+    , buffer_size_(INITIAL_BUFFER_BYTES)
+    , arena_(buffer_.get(), buffer_size_, &overflow_)
+{}
+
+ScratchArena& ScratchArena::instance() {
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+void ScratchArena::release() {
+    arena_.release();
+
+    // Didn't fit? Next time start with a buffer big enough for all of it
+    if (overflow_.bytes > 0) {
+        buffer_size_ += overflow_.bytes;
+        buffer_.reset(new std::byte[buffer_size_]);
+        overflow_.bytes = 0;
+        arena_.~monotonic_buffer_resource();
+        new (&arena_) std::pmr::monotonic_buffer_resource(buffer_.get(), buffer_size_, &overflow_);
+    }
+}
+
+ArenaScope::~ArenaScope() {
+    ScratchArena& arena = ScratchArena::instance();
+    if (--arena.scopes_ == 0) {
+        arena.release();
+    }
+}
+
+} // namespace sudoku_ga
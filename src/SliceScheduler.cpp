@@ -0,0 +1,379 @@
+#include "SliceScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+namespace sudoku_ga {
+
+template<int Order>
+BasicSliceScheduler<Order>::BasicSliceScheduler(const SolverParams& params,
+                                                const SchedulerParams& scheduling)
+    : params_(params)
+    , scheduling_(scheduling)
+    , signal_(std::make_shared<SolveQueueSignal>())
+{
+    scheduling_.max_active = std::max<size_t>(scheduling_.max_active, 1);
+    scheduling_.max_queued = std::max<size_t>(scheduling_.max_queued, 1);
+    scheduling_.slice_generations = std::max(scheduling_.slice_generations, 1);
+
+    int workers = scheduling_.workers;
+    if (workers <= 0) {
+        workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < workers; ++i) {
+        workers_.emplace_back(&BasicSliceScheduler::worker_loop, this, static_cast<size_t>(i));
+    }
+    expiry_thread_ = std::thread(&BasicSliceScheduler::expiry_loop, this);
+}
+
+template<int Order>
+BasicSliceScheduler<Order>::~BasicSliceScheduler() {
+    shutdown();
+}
+
+template<int Order>
+void BasicSliceScheduler<Order>::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        if (shutting_down_) {
+            return;
+        }
+        shutting_down_ = true;
+
+        for (const TaskPtr& task : waiting_) {
+            task->finish_unrun();
+        }
+        waiting_.clear();
+    }
+    work_ready_.notify_all();
+    signal_->room_ready.notify_all();
+    expiry_ready_.notify_all();
+
+    // Solves being stepped stop at the next generation (see worker_loop)
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    expiry_thread_.join();
+
+    // The rest were between turns
+    for (auto& active : active_) {
+        if (active->started) {
+            active->run.stop();
+            active->task->promise.set_value(active->run.result());
+        } else {
+            active->task->finish_unrun();
+        }
+    }
+    active_.clear();
+}
+
+template<int Order>
+size_t BasicSliceScheduler<Order>::queued() const {
+    std::lock_guard<std::mutex> lock(signal_->mutex);
+    auto now = SolveOptions::Clock::now();
+    return static_cast<size_t>(std::count_if(waiting_.begin(), waiting_.end(), [now](const TaskPtr& task) {
+        return !task->claimed && now < task->options.deadline;
+    }));
+}
+
+template<int Order>
+size_t BasicSliceScheduler<Order>::active() const {
+    std::lock_guard<std::mutex> lock(signal_->mutex);
+    return active_.size();
+}
+
+// Take cancelled and expired requests out of the queue, and expired ones
+// out of active_ if they're between turns, completing them. Called with
+// the lock held.
+template<int Order>
+void BasicSliceScheduler<Order>::remove_dead_tasks() {
+    auto now = SolveOptions::Clock::now();
+    for (const TaskPtr& task : waiting_) {
+        if (now >= task->options.deadline) {
+            task->finish_unrun();
+        }
+    }
+
+    size_t before = waiting_.size();
+    waiting_.erase(std::remove_if(waiting_.begin(), waiting_.end(),
+                                  [](const TaskPtr& task) { return task->claimed.load(); }),
+                   waiting_.end());
+    if (waiting_.size() != before) {
+        std::make_heap(waiting_.begin(), waiting_.end(), LaterFirst{});
+        signal_->room_ready.notify_all();
+    }
+
+    // A running solve is stopped by its own worker at the next generation
+    bool removed = false;
+    for (size_t i = 0; i < active_.size();) {
+        Active& active = *active_[i];
+        bool expired = now >= active.task->options.deadline;
+        bool cancelled_unstarted = !active.started && active.task->claimed;
+        bool dead = !active.running && (expired || cancelled_unstarted);
+        if (!dead) {
+            ++i;
+            continue;
+        }
+        if (active.started) {
+            active.run.stop();
+            active.task->promise.set_value(active.run.result());
+        } else {
+            active.task->finish_unrun();
+        }
+        remove(&active);
+        removed = true;
+    }
+    if (removed) {
+        admit();
+        work_ready_.notify_all();
+    }
+}
+
+// Whether a new request fits. Dead entries only get cleared out when the
+// queue looks full, so a normal submit() doesn't scan it.
+template<int Order>
+bool BasicSliceScheduler<Order>::has_room() {
+    if (waiting_.size() >= scheduling_.max_queued) {
+        remove_dead_tasks();
+    }
+    return waiting_.size() < scheduling_.max_queued;
+}
+
+template<int Order>
+BasicSolveHandle<Order> BasicSliceScheduler<Order>::submit(const Grid& puzzle,
+                                                          const SolveOptions& options) {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    signal_->room_ready.wait(lock, [this] { return shutting_down_ || has_room(); });
+    return enqueue(puzzle, options, lock);
+}
+
+template<int Order>
+std::optional<BasicSolveHandle<Order>> BasicSliceScheduler<Order>::try_submit(const Grid& puzzle,
+                                                                              const SolveOptions& options) {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    if (!shutting_down_ && !has_room()) {
+        return std::nullopt;
+    }
+    return enqueue(puzzle, options, lock);
+}
+
+template<int Order>
+BasicSolveHandle<Order> BasicSliceScheduler<Order>::enqueue(const Grid& puzzle,
+                                                           const SolveOptions& options,
+                                                           std::unique_lock<std::mutex>& lock) {
+    if (shutting_down_) {
+        throw std::runtime_error("SliceScheduler has been shut down");
+    }
+
+    auto task = std::make_shared<Task>();
+    task->puzzle = puzzle;
+    task->options = options;
+    task->sequence = next_sequence_++;
+    task->queue_signal = signal_;
+
+    Handle handle;
+    handle.task_ = task;
+    handle.future_ = task->promise.get_future().share();
+
+    // The expiry thread only needs waking if this is now the first deadline
+    bool sooner = options.deadline < next_expiry_;
+    if (sooner) {
+        next_expiry_ = options.deadline;
+    }
+
+    waiting_.push_back(std::move(task));
+    std::push_heap(waiting_.begin(), waiting_.end(), LaterFirst{});
+    admit();
+    lock.unlock();
+    work_ready_.notify_one();
+    if (sooner) {
+        expiry_ready_.notify_one();
+    }
+    return handle;
+}
+
+// =============================================================================
+// Scheduling (all with mutex_ held)
+// =============================================================================
+
+template<int Order>
+void BasicSliceScheduler<Order>::admit() {
+    bool admitted = false;
+    while (active_.size() < scheduling_.max_active && !waiting_.empty()) {
+        std::pop_heap(waiting_.begin(), waiting_.end(), LaterFirst{});
+        TaskPtr task = std::move(waiting_.back());
+        waiting_.pop_back();
+        admitted = true;
+
+        if (task->claimed) {
+            continue;   // Cancelled while it waited
+        }
+        auto active = std::make_unique<Active>();
+        active->task = std::move(task);
+        active->last_turn = turn_count_;
+        active_.push_back(std::move(active));
+    }
+    if (admitted) {
+        signal_->room_ready.notify_all();
+    }
+}
+
+template<int Order>
+double BasicSliceScheduler<Order>::urgency(const Active& active,
+                                           SolveOptions::Clock::time_point now) const {
+    double score = 0.0;
+
+    const SolveOptions& options = active.task->options;
+    if (options.deadline != SolveOptions::Clock::time_point::max()) {
+        double seconds_left = std::chrono::duration<double>(options.deadline - now).count();
+        score += 1.0 / (1.0 + std::max(seconds_left, 0.0));
+    }
+
+    if (active.started) {
+        int conflicts = BasicSudokuGrid<Order>::MAX_SCORE - active.run.best_fitness();
+        score += 1.0 / (1.0 + conflicts);
+        score += static_cast<double>(turn_count_ - active.last_turn) / active_.size();
+    } else {
+        score += 1.0;   // As if it had waited a full round
+    }
+    return score;
+}
+
+template<int Order>
+typename BasicSliceScheduler<Order>::Active* BasicSliceScheduler<Order>::pick() {
+    auto now = SolveOptions::Clock::now();
+    Active* best = nullptr;
+    double best_urgency = 0.0;
+
+    for (auto& active : active_) {
+        if (active->running) {
+            continue;
+        }
+        double score = urgency(*active, now);
+        if (!best || active->task->options.priority > best->task->options.priority ||
+            (active->task->options.priority == best->task->options.priority && score > best_urgency)) {
+            best = active.get();
+            best_urgency = score;
+        }
+    }
+    return best;
+}
+
+template<int Order>
+void BasicSliceScheduler<Order>::remove(Active* active) {
+    auto it = std::find_if(active_.begin(), active_.end(),
+                           [active](const auto& entry) { return entry.get() == active; });
+    std::swap(*it, active_.back());
+    active_.pop_back();
+}
+
+// =============================================================================
+// Workers
+// =============================================================================
+
+template<int Order>
+void BasicSliceScheduler<Order>::worker_loop(size_t index) {
+    // A run's population lives where it was started; later turns may be
+    // on another worker, but pinned workers at least don't wander
+    pin_current_thread(scheduling_.affinity, index);
+    
+    // Each thread steps whichever solve is next with its own solver; the
+    // per-solve state travels in the BasicSolveRun
+    SolverParams params = params_;
+    params.report_interval = 0;
+    params.checkpoint_path.clear();
+    BasicSolver<Order> solver(params);
+
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    while (true) {
+        Active* active = nullptr;
+        work_ready_.wait(lock, [this, &active] {
+            return shutting_down_ || (active = pick()) != nullptr;
+        });
+        if (shutting_down_) {
+            return;
+        }
+
+        // Don't start what's already too late. Once claimed, cancel() leaves
+        // the promise to us and the stop condition ends the solve.
+        Task& task = *active->task;
+        if (!active->started && (task.should_stop() || task.claimed.exchange(true))) {
+            task.finish_unrun();   // No-op if cancel() already completed it
+            remove(active);
+            admit();
+            continue;
+        }
+        active->running = true;
+        lock.unlock();
+
+        // One turn
+        std::exception_ptr error;
+        solver.set_stop_condition([&task, this] { return task.should_stop() || shutting_down_; });
+        try {
+            if (!active->started) {
+                active->run = solver.start(task.puzzle);
+                active->started = true;
+            }
+            if (task.should_stop() || shutting_down_) {
+                active->run.stop();
+            } else {
+                solver.step(active->run, scheduling_.slice_generations);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        solver.set_stop_condition(nullptr);
+
+        lock.lock();
+        active->running = false;
+        active->last_turn = ++turn_count_;
+        if (error) {
+            task.promise.set_exception(error);
+            remove(active);
+            admit();
+        } else if (active->run.finished()) {
+            task.promise.set_value(active->run.result());
+            remove(active);
+            admit();
+        } else if (task.options.deadline < next_expiry_) {
+            // Between turns now, so the expiry thread looks after its deadline
+            next_expiry_ = task.options.deadline;
+            expiry_ready_.notify_one();
+        }
+        // This solve (or a newly admitted one) is ready for someone else
+        work_ready_.notify_one();
+    }
+}
+
+// Completes requests whose deadline passes while they wait (in the queue
+// or between turns), so nobody waits on one just because every worker is busy
+template<int Order>
+void BasicSliceScheduler<Order>::expiry_loop() {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    while (!shutting_down_) {
+        remove_dead_tasks();
+
+        next_expiry_ = SolveOptions::Clock::time_point::max();
+        for (const TaskPtr& task : waiting_) {
+            next_expiry_ = std::min(next_expiry_, task->options.deadline);
+        }
+        for (const auto& active : active_) {
+            if (!active->running) {
+                next_expiry_ = std::min(next_expiry_, active->task->options.deadline);
+            }
+        }
+        if (next_expiry_ == SolveOptions::Clock::time_point::max()) {
+            expiry_ready_.wait(lock);
+        } else {
+            expiry_ready_.wait_until(lock, next_expiry_);
+        }
+    }
+}
+
+template class BasicSliceScheduler<3>;
+template class BasicSliceScheduler<4>;
+template class BasicSliceScheduler<5>;
+
+} // namespace sudoku_ga
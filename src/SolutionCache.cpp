@@ -0,0 +1,92 @@
+#include "SolutionCache.hpp"
+
+namespace sudoku_ga {
+
+template<int Order>
+BasicSolutionCache<Order>::BasicSolutionCache(size_t max_entries)
+    : max_entries_(max_entries)
+{}
+
+template<int Order>
+bool BasicSolutionCache<Order>::cacheable(const Grid& puzzle) {
+    int givens = 0;
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            givens += puzzle.get(row, col) != 0;
+        }
+    }
+    return givens >= MIN_GIVENS;
+}
+
+template<int Order>
+bool BasicSolutionCache<Order>::lookup(const Grid& puzzle, Grid& solution) const {
+    Lookup probe;
+    return lookup(puzzle, solution, probe);
+}
+
+template<int Order>
+bool BasicSolutionCache<Order>::lookup(const Grid& puzzle, Grid& solution, Lookup& probe) const {
+    probe.cacheable = cacheable(puzzle);
+    if (!probe.cacheable) {
+        ++misses_;
+        return false;
+    }
+    probe.transform = canonical_transform(puzzle);
+    probe.key = grid_to_string(probe.transform.apply(puzzle));
+    auto it = entries_.find(probe.key);
+    if (it == entries_.end()) {
+        ++misses_;
+        return false;
+    }
+
+    // Back to the caller's orientation, keeping their fixed cells
+    Grid mapped = probe.transform.invert(Grid(it->second));
+    Grid result(puzzle);
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            result.set(row, col, mapped.get(row, col));
+        }
+    }
+
+    // Never hand out an entry without checking it solves this puzzle
+    if (!result.solves(puzzle)) {
+        ++misses_;
+        return false;
+    }
+
+    solution = result;
+    ++hits_;
+    return true;
+}
+
+template<int Order>
+void BasicSolutionCache<Order>::store(const Grid& puzzle, const Grid& solution) {
+    Lookup probe;
+    probe.cacheable = cacheable(puzzle);
+    if (probe.cacheable) {
+        probe.transform = canonical_transform(puzzle);
+        probe.key = grid_to_string(probe.transform.apply(puzzle));
+    }
+    store(probe, puzzle, solution);
+}
+
+template<int Order>
+void BasicSolutionCache<Order>::store(const Lookup& probe, const Grid& puzzle, const Grid& solution) {
+    if (entries_.size() >= max_entries_ || !probe.cacheable || !solution.solves(puzzle)) {
+        return;
+    }
+    entries_.emplace(probe.key, grid_to_string(probe.transform.apply(solution)));
+}
+
+template<int Order>
+void BasicSolutionCache<Order>::clear() {
+    entries_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+template class BasicSolutionCache<3>;
+template class BasicSolutionCache<4>;
+template class BasicSolutionCache<5>;
+
+} // namespace sudoku_ga
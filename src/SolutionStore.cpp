@@ -0,0 +1,448 @@
+#include "SolutionStore.hpp"
+#include "Canonical.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sudoku_ga {
+
+namespace {
+
+constexpr char DATA_MAGIC[4] = {'S', 'G', 'A', 'D'};
+constexpr char INDEX_MAGIC[4] = {'S', 'G', 'A', 'I'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+// Smallest index; always a power of two so probing can use a mask
+constexpr uint64_t INITIAL_CAPACITY = 1024;
+
+struct DataHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t order;
+    uint32_t reserved;
+};
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t order;
+    uint32_t reserved;
+    uint64_t capacity;    // Number of slots
+    uint64_t count;       // Records indexed (must match the data file)
+};
+
+// record is the record number + 1, so an all-zero slot is empty
+struct Slot {
+    uint64_t hash;
+    uint64_t record;
+};
+
+/*
+ * Packing grids into bytes
+ *
+ * Each cell takes BITS bits (enough for 0..SIZE), written one after
+ * another with the low bits first. 9x9 takes 41 bytes.
+ */
+template<int Order>
+struct Packing {
+    using Grid = BasicSudokuGrid<Order>;
+
+    static constexpr int BITS = Order == 3 ? 4 : 5;
+    static constexpr size_t BYTES = (Grid::NUM_CELLS * BITS + 7) / 8;
+    static constexpr size_t RECORD_BYTES = 2 * BYTES;   // key + solution
+
+    static void pack(const Grid& grid, uint8_t* out) {
+        std::memset(out, 0, BYTES);
+        for (int cell = 0; cell < Grid::NUM_CELLS; ++cell) {
+            unsigned value = grid.get(cell);
+            size_t bit = static_cast<size_t>(cell) * BITS;
+            out[bit / 8] |= static_cast<uint8_t>(value << (bit % 8));
+            if (bit % 8 + BITS > 8) {
+                out[bit / 8 + 1] |= static_cast<uint8_t>(value >> (8 - bit % 8));
+            }
+        }
+    }
+
+    static Grid unpack(const uint8_t* in) {
+        Grid grid;
+        for (int cell = 0; cell < Grid::NUM_CELLS; ++cell) {
+            size_t bit = static_cast<size_t>(cell) * BITS;
+            unsigned value = in[bit / 8] >> (bit % 8);
+            if (bit % 8 + BITS > 8) {
+                value |= static_cast<unsigned>(in[bit / 8 + 1]) << (8 - bit % 8);
+            }
+            grid.set(cell, value & ((1u << BITS) - 1));
+        }
+        return grid;
+    }
+};
+
+// FNV-1a
+uint64_t hash_bytes(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+[[noreturn]] void fail(const std::string& what, const std::string& path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+// =============================================================================
+// Opening and closing
+// =============================================================================
+
+template<int Order>
+BasicSolutionStore<Order>::BasicSolutionStore(const std::string& path)
+    : data_path_(path + ".dat")
+    , index_path_(path + ".idx")
+{
+    try {
+        open_data();
+        open_index();
+    } catch (...) {
+        unmap_index();
+        if (index_fd_ >= 0) close(index_fd_);
+        if (data_fd_ >= 0) close(data_fd_);
+        throw;
+    }
+}
+
+template<int Order>
+BasicSolutionStore<Order>::~BasicSolutionStore() {
+    unmap_index();
+    if (index_fd_ >= 0) close(index_fd_);
+    if (data_fd_ >= 0) close(data_fd_);
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::open_data() {
+    using Pack = Packing<Order>;
+
+    data_fd_ = open(data_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (data_fd_ < 0) {
+        fail("Cannot open", data_path_);
+    }
+
+    struct stat info;
+    if (fstat(data_fd_, &info) != 0) {
+        fail("Cannot stat", data_path_);
+    }
+
+    DataHeader header{};
+    if (info.st_size == 0) {
+        std::memcpy(header.magic, DATA_MAGIC, 4);
+        header.version = FORMAT_VERSION;
+        header.order = Order;
+        if (pwrite(data_fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            fail("Cannot write", data_path_);
+        }
+        record_count_ = 0;
+        return;
+    }
+
+    if (pread(data_fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, DATA_MAGIC, 4) != 0 || header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Not a solution store: " + data_path_);
+    }
+    if (header.order != static_cast<uint32_t>(Order)) {
+        throw std::runtime_error("Solution store is for a different board size: " + data_path_);
+    }
+
+    // Drop a record that was only partly written
+    record_count_ = (static_cast<uint64_t>(info.st_size) - sizeof(header)) / Pack::RECORD_BYTES;
+    off_t whole = static_cast<off_t>(sizeof(header) + record_count_ * Pack::RECORD_BYTES);
+    if (whole != info.st_size && ftruncate(data_fd_, whole) != 0) {
+        fail("Cannot truncate", data_path_);
+    }
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::open_index() {
+    index_fd_ = open(index_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (index_fd_ < 0) {
+        fail("Cannot open", index_path_);
+    }
+
+    struct stat info;
+    if (fstat(index_fd_, &info) != 0) {
+        fail("Cannot stat", index_path_);
+    }
+
+    // Use the existing index only if it matches the data file exactly
+    IndexHeader header{};
+    bool usable = static_cast<size_t>(info.st_size) >= sizeof(header) &&
+        pread(index_fd_, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+        std::memcmp(header.magic, INDEX_MAGIC, 4) == 0 &&
+        header.version == FORMAT_VERSION &&
+        header.order == static_cast<uint32_t>(Order) &&
+        header.capacity >= INITIAL_CAPACITY &&
+        (header.capacity & (header.capacity - 1)) == 0 &&
+        static_cast<uint64_t>(info.st_size) == sizeof(header) + header.capacity * sizeof(Slot) &&
+        header.count == record_count_ &&
+        2 * header.count <= header.capacity;
+
+    if (usable) {
+        map_index(header.capacity, false);
+        return;
+    }
+
+    uint64_t capacity = INITIAL_CAPACITY;
+    while (2 * (record_count_ + 1) > capacity) {
+        capacity *= 2;
+    }
+    rebuild_index(capacity);
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::map_index(size_t capacity, bool create) {
+    index_bytes_ = sizeof(IndexHeader) + capacity * sizeof(Slot);
+
+    // Truncating to zero first makes every slot read back as empty
+    if (create && (ftruncate(index_fd_, 0) != 0 ||
+                   ftruncate(index_fd_, static_cast<off_t>(index_bytes_)) != 0)) {
+        fail("Cannot resize", index_path_);
+    }
+
+    void* map = mmap(nullptr, index_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, index_fd_, 0);
+    if (map == MAP_FAILED) {
+        fail("Cannot map", index_path_);
+    }
+    index_map_ = map;
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::unmap_index() {
+    if (index_map_ != nullptr) {
+        munmap(index_map_, index_bytes_);
+        index_map_ = nullptr;
+    }
+}
+
+// Built in a temporary file and renamed over the old index, so a crash
+// part-way through leaves either the old index or the new one
+template<int Order>
+void BasicSolutionStore<Order>::rebuild_index(size_t capacity) {
+    unmap_index();
+    if (index_fd_ >= 0) {
+        close(index_fd_);
+    }
+
+    std::string temp_path = index_path_ + ".tmp";
+    index_fd_ = open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (index_fd_ < 0) {
+        fail("Cannot create", temp_path);
+    }
+    map_index(capacity, true);
+
+    auto* header = static_cast<IndexHeader*>(index_map_);
+    std::memcpy(header->magic, INDEX_MAGIC, 4);
+    header->version = FORMAT_VERSION;
+    header->order = Order;
+    header->capacity = capacity;
+
+    for (uint64_t record = 0; record < record_count_; ++record) {
+        Key key = read_key(record);
+        insert_slot(hash_bytes(key.data(), key.size()), record);
+    }
+    header->count = record_count_;
+
+    if (msync(index_map_, index_bytes_, MS_SYNC) != 0 ||
+        rename(temp_path.c_str(), index_path_.c_str()) != 0) {
+        fail("Cannot write", index_path_);
+    }
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::flush() {
+    if (msync(index_map_, index_bytes_, MS_SYNC) != 0) {
+        fail("Cannot sync", index_path_);
+    }
+    if (fdatasync(data_fd_) != 0) {
+        fail("Cannot sync", data_path_);
+    }
+}
+
+// =============================================================================
+// Index and records
+// =============================================================================
+
+template<int Order>
+size_t BasicSolutionStore<Order>::find_slot(uint64_t hash, const Key& key, bool& found) const {
+    auto* header = static_cast<const IndexHeader*>(index_map_);
+    auto* slots = reinterpret_cast<const Slot*>(header + 1);
+    size_t mask = header->capacity - 1;
+
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        if (slots[i].record == 0) {
+            found = false;
+            return i;
+        }
+        // Equal hashes aren't enough - compare the actual keys
+        if (slots[i].hash == hash && read_key(slots[i].record - 1) == key) {
+            found = true;
+            return i;
+        }
+    }
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::insert_slot(uint64_t hash, uint64_t record) {
+    auto* header = static_cast<IndexHeader*>(index_map_);
+    auto* slots = reinterpret_cast<Slot*>(header + 1);
+    size_t mask = header->capacity - 1;
+
+    size_t i = hash & mask;
+    while (slots[i].record != 0) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = Slot{hash, record + 1};
+}
+
+template<int Order>
+std::vector<uint8_t> BasicSolutionStore<Order>::read_record(uint64_t record) const {
+    using Pack = Packing<Order>;
+
+    std::vector<uint8_t> bytes(Pack::RECORD_BYTES);
+    off_t offset = static_cast<off_t>(sizeof(DataHeader) + record * Pack::RECORD_BYTES);
+    if (pread(data_fd_, bytes.data(), bytes.size(), offset) != static_cast<ssize_t>(bytes.size())) {
+        fail("Cannot read", data_path_);
+    }
+    return bytes;
+}
+
+template<int Order>
+typename BasicSolutionStore<Order>::Key BasicSolutionStore<Order>::read_key(uint64_t record) const {
+    std::vector<uint8_t> bytes = read_record(record);
+    bytes.resize(Packing<Order>::BYTES);
+    return bytes;
+}
+
+// =============================================================================
+// Lookup and store
+// =============================================================================
+
+template<int Order>
+void BasicSolutionStore<Order>::prepare(const Grid& puzzle, Lookup& probe) const {
+    using Pack = Packing<Order>;
+
+    probe.cacheable = BasicSolutionCache<Order>::cacheable(puzzle);
+    if (!probe.cacheable) {
+        return;
+    }
+    probe.transform = canonical_transform(puzzle);
+    probe.key.resize(Pack::BYTES);
+    Pack::pack(probe.transform.apply(puzzle), probe.key.data());
+    probe.hash = hash_bytes(probe.key.data(), probe.key.size());
+}
+
+template<int Order>
+bool BasicSolutionStore<Order>::lookup(const Grid& puzzle, Grid& solution) {
+    Lookup probe;
+    return lookup(puzzle, solution, probe);
+}
+
+template<int Order>
+bool BasicSolutionStore<Order>::lookup(const Grid& puzzle, Grid& solution, Lookup& probe) {
+    using Pack = Packing<Order>;
+
+    prepare(puzzle, probe);
+    if (!probe.cacheable) {
+        ++misses_;
+        return false;
+    }
+
+    bool found = false;
+    size_t slot = find_slot(probe.hash, probe.key, found);
+    if (!found) {
+        ++misses_;
+        return false;
+    }
+
+    auto* slots = reinterpret_cast<const Slot*>(static_cast<const IndexHeader*>(index_map_) + 1);
+    std::vector<uint8_t> record = read_record(slots[slot].record - 1);
+    Grid mapped = probe.transform.invert(Pack::unpack(record.data() + Pack::BYTES));
+
+    // Back to the caller's orientation, keeping their fixed cells
+    Grid result(puzzle);
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            result.set(row, col, mapped.get(row, col));
+        }
+    }
+
+    // A damaged file must never produce a wrong answer
+    if (!result.solves(puzzle)) {
+        ++misses_;
+        return false;
+    }
+
+    solution = result;
+    ++hits_;
+    return true;
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::store(const Grid& puzzle, const Grid& solution) {
+    // Skip canonicalizing when the solution is going to be ignored anyway
+    if (!solution.solves(puzzle)) {
+        return;
+    }
+    Lookup probe;
+    prepare(puzzle, probe);
+    store(probe, puzzle, solution);
+}
+
+template<int Order>
+void BasicSolutionStore<Order>::store(const Lookup& probe, const Grid& puzzle, const Grid& solution) {
+    using Pack = Packing<Order>;
+
+    if (!probe.cacheable || !solution.solves(puzzle)) {
+        return;
+    }
+
+    // Stored since the lookup? (Cheap: no canonicalizing, just probing)
+    bool found = false;
+    find_slot(probe.hash, probe.key, found);
+    if (found) {
+        return;
+    }
+
+    std::vector<uint8_t> record(Pack::RECORD_BYTES);
+    std::memcpy(record.data(), probe.key.data(), Pack::BYTES);
+    Pack::pack(probe.transform.apply(solution), record.data() + Pack::BYTES);
+
+    // Keep the index at most half full so probe sequences stay short
+    auto* header = static_cast<IndexHeader*>(index_map_);
+    if (2 * (record_count_ + 1) > header->capacity) {
+        rebuild_index(header->capacity * 2);
+        header = static_cast<IndexHeader*>(index_map_);
+    }
+
+    // Data first, then the index: if we die in between, the counts won't
+    // match on the next open and the index gets rebuilt
+    off_t offset = static_cast<off_t>(sizeof(DataHeader) + record_count_ * Pack::RECORD_BYTES);
+    if (pwrite(data_fd_, record.data(), record.size(), offset) != static_cast<ssize_t>(record.size())) {
+        fail("Cannot write", data_path_);
+    }
+    insert_slot(probe.hash, record_count_);
+    ++record_count_;
+    header->count = record_count_;
+}
+
+template class BasicSolutionStore<3>;
+template class BasicSolutionStore<4>;
+template class BasicSolutionStore<5>;
+
+} // namespace sudoku_ga
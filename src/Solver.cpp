@@ -1,148 +1,454 @@
 #include "Solver.hpp"
 #include "GeneticOperations.hpp"
 #include "RandomUtils.hpp"
+#include "ScratchArena.hpp"
+#include "WorkStealingPool.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 namespace sudoku_ga {
 
-Solver::Solver(const SolverParams& params)
+namespace {
+
+// Split offspring slots [first, size) into ranges for parallel breeding: a
+// few per worker so stealing can even out the uneven cost of local search,
+// and even-sized (whole pairs of children) except for the last one
+std::vector<std::pair<size_t, size_t>> breeding_slices(size_t first, size_t size, size_t workers) {
+    std::vector<std::pair<size_t, size_t>> slices;
+    size_t pairs = (size - first + 1) / 2;
+    size_t jobs = std::max<size_t>(1, std::min(pairs, workers * 4));
+    for (size_t j = 0; j < jobs; ++j) {
+        size_t begin = first + 2 * (pairs * j / jobs);
+        size_t end = std::min(size, first + 2 * (pairs * (j + 1) / jobs));
+        if (begin < end) {
+            slices.emplace_back(begin, end);
+        }
+    }
+    return slices;
+}
+
+} // namespace
+
+// =============================================================================
+// BasicSolveRun
+// =============================================================================
+
+template<int Order>
+int BasicSolveRun<Order>::best_fitness() const {
+    return population_.best_fitness();
+}
+
+template<int Order>
+void BasicSolveRun<Order>::stop() {
+    if (!finished_) {
+        finish(false, true);
+    }
+}
+
+template<int Order>
+void BasicSolveRun<Order>::finish(bool solved, bool stopped) {
+    result_.solved = solved;
+    result_.stopped = stopped;
+    result_.generations = generation_;
+    result_.elapsed_seconds = elapsed_seconds_;
+    if (solved) {
+        result_.best_fitness = BasicSudokuGrid<Order>::MAX_SCORE;
+        result_.best_individual = *population_.get_solution();
+    } else {
+        result_.best_fitness = population_.best_fitness();
+        result_.best_individual = population_.get_best();
+    }
+    finished_ = true;
+}
+
+// =============================================================================
+// BasicSolver
+// =============================================================================
+
+template<int Order>
+BasicSolver<Order>::BasicSolver(const SolverParams& params)
     : params_(params)
 {}
 
 // Print current progress to the console
-void Solver::print_progress(int generation, const Population& population) {
-    if (params_.report_interval > 0 && generation % params_.report_interval == 0) {
-        std::cout << "Generation " << generation 
-                  << " | Best: " << population.best_fitness()
-                  << " | Avg: " << population.average_fitness()
-                  << " | Worst: " << population.worst_fitness()
+template<int Order>
+void BasicSolver<Order>::print_progress(const Run& run) {
+    if (params_.report_interval > 0 && run.generation_ % params_.report_interval == 0) {
+        std::cout << "Generation " << run.generation_
+                  << " | Best: " << run.population_.best_fitness()
+                  << " | Avg: " << run.population_.average_fitness()
+                  << " | Worst: " << run.population_.worst_fitness()
                   << std::endl;
     }
 }
 
+// Make two children from two parents. Shared by the sequential and
+// parallel breeding loops.
+// Rates come from `rates` (rates_, or a copy when breeding in parallel),
+// which also collects feedback when adaptive.
+template<int Order>
+void BasicSolver<Order>::breed(const Chromosome& parent1, const Chromosome& parent2,
+                   Chromosome& child1, Chromosome& child2, AdaptiveRates& rates) {
+    // Step 2: Maybe do crossover (combine the parents)
+    bool crossed = rng().rand_double() < rates.crossover_rate();
+    if (crossed) {
+        // Do crossover - build the two children in place
+        crossover_into(parent1, parent2, child1, child2);
+    } else {
+        // No crossover - just copy parents and mutate them
+        child1 = parent1;
+        child2 = parent2;
+    }
+    
+    // Steps 3 and 4: mutation and optional local search
+    improve_child(child1, rates);
+    improve_child(child2, rates);
+    
+    if (params_.adaptive_rates) {
+        int better_parent = std::max(parent1.fitness(), parent2.fitness());
+        rates.record_offspring(crossed, child1.fitness() > better_parent);
+        rates.record_offspring(crossed, child2.fitness() > better_parent);
+    }
+}
+
+template<int Order>
+void BasicSolver<Order>::improve_child(Chromosome& child, AdaptiveRates& rates) {
+    int before = child.fitness();
+    if (params_.conflict_directed_mutation) {
+        mutate_conflicts(child, rates.mutation_rate());
+    } else {
+        mutate(child, rates.mutation_rate());
+    }
+    if (params_.adaptive_rates) {
+        rates.record_mutation(child.fitness() > before);
+    }
+    
+    if (params_.use_local_search && !params_.local_search_elite_only) {
+        apply_local_search(child, rates);
+    }
+}
+
+template<int Order>
+void BasicSolver<Order>::apply_local_search(Chromosome& chrom, AdaptiveRates& rates) {
+    // A single random swap isn't worth it, but one exhaustive step is
+    int candidates = rates.local_search_candidates();
+    if (candidates < min_local_search_candidates()) {
+        return;
+    }
+    
+    int before = chrom.fitness();
+    local_search(chrom, params_.local_search_strategy, candidates, params_.local_search_whole_grid);
+    if (params_.adaptive_rates) {
+        rates.record_local_search(chrom.fitness() > before);
+    }
+}
+
+template<int Order>
+int BasicSolver<Order>::min_local_search_candidates() const {
+    return params_.local_search_strategy == LocalSearchStrategy::Random ? 2 : 1;
+}
+
+template<int Order>
+void BasicSolver<Order>::reset_rates() {
+    rates_.reset(params_.crossover_rate, params_.mutation_rate,
+                 params_.local_search_candidates, min_local_search_candidates());
+}
+
 // This is the heart of the GA - one generation of evolution
-void Solver::run_generation(Population& population) {
-    std::vector<Chromosome> new_generation;
-    new_generation.reserve(population.size());
+// Returns true as soon as a child is a perfect solution; the rest of the
+// generation is skipped and the population holds the offspring built so far.
+template<int Order>
+bool BasicSolver<Order>::run_generation(Population& population) {
+    // Children are bred straight into the slots of the reused buffer
+    std::vector<Chromosome>& new_generation = next_generation_;
+    size_t size = population.size();
+    new_generation.resize(size);
+    size_t filled = 0;
+    bool solved = false;
     
     // Elitism: copy the best individual directly to the next generation
-    // This ensures we never lose our best solution
+    // This ensures we never lose our best solution (and it's where
+    // elite-only local search happens)
     if (params_.elitism) {
-        new_generation.push_back(population.get_best());
+        new_generation[filled] = population.get_best();
+        if (params_.use_local_search && params_.local_search_elite_only) {
+            apply_local_search(new_generation[filled], rates_);
+        }
+        solved = new_generation[filled++].is_solution();
+    }
+    
+    if (params_.parallel_generation && !solved) {
+        filled = breed_parallel(population, new_generation, filled, solved);
     }
     
     // Fill the rest of the new generation with offspring
-    while (new_generation.size() < population.size()) {
+    Chromosome spare;  // Second child when only one slot is left
+    while (filled < size && !solved) {
+        // Operator scratch (tournaments, mutations) for this pair comes from
+        // the thread's arena and is handed back in one go afterwards, so the
+        // same few KB are reused - and stay in cache - for every pair
+        ArenaScope arena;
+        
         // Step 1: Select two parents using tournament selection
         auto [parent1, parent2] = population.select_parents(params_.tournament_size);
         
-        // Step 2: Maybe do crossover (combine the parents)
-        if (rng().rand_double() < params_.crossover_rate) {
-            // Do crossover - create two children from the parents
-            auto [child1, child2] = crossover(*parent1, *parent2);
-            
-            // Step 3: Apply mutation to the children
-            mutate(child1, params_.mutation_rate);
-            mutate(child2, params_.mutation_rate);
-            
-            // Step 4: Optional local search (try to improve the children)
-            if (params_.use_local_search && params_.local_search_candidates > 1) {
-                child1 = local_search(child1, params_.local_search_candidates);
-                child2 = local_search(child2, params_.local_search_candidates);
-            }
-            
-            // Add children to new generation
-            new_generation.push_back(std::move(child1));
-            if (new_generation.size() < population.size()) {
-                new_generation.push_back(std::move(child2));
-            }
-        } else {
-            // No crossover - just copy parents and mutate them
-            Chromosome child1 = *parent1;
-            Chromosome child2 = *parent2;
-            
-            mutate(child1, params_.mutation_rate);
-            mutate(child2, params_.mutation_rate);
-            
-            if (params_.use_local_search && params_.local_search_candidates > 1) {
-                child1 = local_search(child1, params_.local_search_candidates);
-                child2 = local_search(child2, params_.local_search_candidates);
-            }
-            
-            new_generation.push_back(std::move(child1));
-            if (new_generation.size() < population.size()) {
-                new_generation.push_back(std::move(child2));
+        // Steps 2-4: crossover, mutation, local search
+        Chromosome& child1 = new_generation[filled];
+        Chromosome& child2 = filled + 1 < size ? new_generation[filled + 1] : spare;
+        breed(*parent1, *parent2, child1, child2, rates_);
+        
+        // Stop right away if a child is a solution, instead of building
+        // the rest of the generation
+        bool has_room_for_child2 = filled + 1 < size;
+        solved = child1.is_solution() || (has_room_for_child2 && child2.is_solution());
+        filled = std::min(filled + 2, size);
+    }
+    
+    // Out with the old, in with the new. An early exit leaves only the
+    // offspring built so far. The old individuals come back in the buffer.
+    new_generation.resize(filled);
+    population.swap_generation(new_generation);
+    if (params_.adaptive_rates) {
+        rates_.end_generation();
+    }
+    return solved;
+}
+
+// =============================================================================
+// Parallel breeding (params_.parallel_generation)
+// =============================================================================
+
+// Rates for one parallel job: the current rates, with no feedback yet
+template<int Order>
+std::vector<AdaptiveRates> BasicSolver<Order>::job_rates(size_t count) const {
+    AdaptiveRates rates;
+    rates.restore(rates_.state());
+    return std::vector<AdaptiveRates>(count, rates);
+}
+
+// The offspring loop of run_generation, as jobs on the shared pool. Each
+// job breeds into its own range of slots with its own copy of the rates.
+// When a child solves the puzzle the jobs stop early, and the slots they
+// did fill are moved to the front. Returns how many slots are filled.
+template<int Order>
+size_t BasicSolver<Order>::breed_parallel(Population& population,
+                                          std::vector<Chromosome>& new_generation,
+                                          size_t first, bool& solved) {
+    TaskGroup group;
+    auto slices = breeding_slices(first, new_generation.size(), group.pool().worker_count());
+    std::vector<size_t> done(slices.size(), 0);
+    std::vector<AdaptiveRates> rates = job_rates(slices.size());
+    std::atomic<bool> found{false};
+    
+    for (size_t j = 0; j < slices.size(); ++j) {
+        group.run([&, j] {
+            auto [slot, end] = slices[j];
+            Chromosome spare;
+            while (slot < end && !found) {
+                ArenaScope arena;   // The worker's own arena
+                auto [parent1, parent2] = population.select_parents(params_.tournament_size);
+                Chromosome& child1 = new_generation[slot];
+                Chromosome& child2 = slot + 1 < end ? new_generation[slot + 1] : spare;
+                breed(*parent1, *parent2, child1, child2, rates[j]);
+                
+                if (child1.is_solution() || (slot + 1 < end && child2.is_solution())) {
+                    found = true;
+                }
+                slot = std::min(slot + 2, end);
             }
+            done[j] = slot - slices[j].first;
+        });
+    }
+    group.wait();
+    
+    if (params_.adaptive_rates) {
+        for (const auto& job : rates) {
+            rates_.add_feedback(job);
         }
     }
     
-    // Out with the old, in with the new
-    population.replace_generation(std::move(new_generation));
+    size_t filled = first;
+    for (size_t j = 0; j < slices.size(); ++j) {
+        for (size_t k = slices[j].first; k < slices[j].first + done[j]; ++k) {
+            if (k != filled) {
+                std::swap(new_generation[filled], new_generation[k]);
+            }
+            ++filled;
+        }
+    }
+    solved = found;
+    return filled;
+}
+
+template<int Order>
+bool BasicSolver<Order>::checkpoint_due(int generation) const {
+    return params_.checkpoint_interval > 0 && !params_.checkpoint_path.empty() &&
+           generation % params_.checkpoint_interval == 0;
+}
+
+template<int Order>
+void BasicSolver<Order>::save(const Run& run, double elapsed_seconds) {
+    BasicCheckpoint<Order> checkpoint;
+    checkpoint.generation = run.generation_;
+    checkpoint.elapsed_seconds = elapsed_seconds;
+    checkpoint.rates = rates_.state();
+    checkpoint.rng_state = rng().state();
+    checkpoint.individuals.assign(run.population_.begin(), run.population_.end());
+    save_checkpoint(params_.checkpoint_path, run.puzzle_, checkpoint);
+}
+
+template<int Order>
+void BasicSolver<Order>::restore(const BasicCheckpoint<Order>& checkpoint) {
+    rates_.restore(checkpoint.rates);
+    if (!rng().set_state(checkpoint.rng_state)) {
+        throw std::runtime_error("Checkpoint has a bad random generator state");
+    }
+}
+
+template<int Order>
+BasicSolverResult<Order> BasicSolver<Order>::solve(const Grid& puzzle) {
+    Run run = begin(puzzle, nullptr);
+    step(run, params_.max_generations);
+    return run.result_;
+}
+
+template<int Order>
+BasicSolverResult<Order> BasicSolver<Order>::resume(const Grid& puzzle,
+                                                    const std::string& checkpoint_path) {
+    BasicCheckpoint<Order> checkpoint = load_checkpoint(checkpoint_path, puzzle);
+    Run run = begin(puzzle, &checkpoint);
+    step(run, params_.max_generations);
+    return run.result_;
 }
 
-// Main solving loop
-SolverResult Solver::solve(const SudokuGrid& puzzle) {
+template<int Order>
+BasicSolveRun<Order> BasicSolver<Order>::start(const Grid& puzzle) {
+    return begin(puzzle, nullptr);
+}
+
+// Set up a run: the first generation, or the one saved in the checkpoint
+template<int Order>
+BasicSolveRun<Order> BasicSolver<Order>::begin(const Grid& puzzle,
+                                               const BasicCheckpoint<Order>* checkpoint) {
+    // Scratch for building the first generation (see ScratchArena)
+    ArenaScope arena;
+    reset_rates();
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    SolverResult result;
+    Run run;
+    run.puzzle_ = puzzle;
+    
+    if (checkpoint) {
+        // Pick up exactly where the checkpoint left off
+        std::vector<Chromosome> individuals = checkpoint->individuals;
+        run.population_.swap_generation(individuals);
+        restore(*checkpoint);
+        run.generation_ = checkpoint->generation;
+        run.elapsed_seconds_ = checkpoint->elapsed_seconds;
+    } else {
+        run.population_ = Population(puzzle, params_.population_size);
+    }
+    run.rates_ = rates_.state();
     
-    // Create the initial population
-    Population population(puzzle, params_.population_size);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    run.elapsed_seconds_ += std::chrono::duration<double>(end_time - start_time).count();
     
     // Maybe we got lucky and one of the random initializations is already a solution?
-    if (population.has_solution()) {
-        result.solved = true;
-        result.generations = 0;
-        result.best_fitness = SudokuGrid::MAX_SCORE;
-        result.best_individual = *population.get_solution();
-        
-        auto end_time = std::chrono::high_resolution_clock::now();
-        result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
-        return result;
+    bool solved = run.population_.has_solution();
+    if (solved || run.generation_ >= params_.max_generations) {
+        run.finish(solved, false);
+    } else if (!checkpoint) {
+        // Show starting point
+        print_progress(run);
+    }
+    return run;
+}
+
+// Main evolution loop, a slice at a time
+template<int Order>
+bool BasicSolver<Order>::step(Run& run, int generations) {
+    if (run.finished_) {
+        return true;
     }
     
-    // Show starting point
-    print_progress(0, population);
+    // This run's rates, not whatever the last run left behind
+    rates_.restore(run.rates_);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    bool solved = false;
+    bool stopped = false;
     
-    // Main evolution loop
-    for (int gen = 1; gen <= params_.max_generations; ++gen) {
-        // Evolve one generation
-        run_generation(population);
+    for (int n = 0; n < generations && run.generation_ < params_.max_generations; ++n) {
+        int gen = ++run.generation_;
+        
+        // Evolve one generation (stops early if a child solves the puzzle)
+        solved = run_generation(run.population_) || run.population_.has_solution();
         
-        // Did we find a solution?
-        if (population.has_solution()) {
-            result.solved = true;
-            result.generations = gen;
-            result.best_fitness = SudokuGrid::MAX_SCORE;
-            result.best_individual = *population.get_solution();
-            
+        if (solved) {
             if (params_.report_interval > 0) {
                 std::cout << "Solution found at generation " << gen << "!" << std::endl;
             }
-            
-            auto end_time = std::chrono::high_resolution_clock::now();
-            result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
-            return result;
+            break;
         }
         
         // Show progress
-        print_progress(gen, population);
+        print_progress(run);
+        
+        if (checkpoint_due(gen)) {
+            auto now = std::chrono::high_resolution_clock::now();
+            save(run, run.elapsed_seconds_ + std::chrono::duration<double>(now - start_time).count());
+        }
+        
+        if (should_stop_ && should_stop_()) {
+            stopped = true;
+            break;
+        }
     }
     
-    // We ran out of generations without finding a perfect solution
-    result.solved = false;
-    result.generations = params_.max_generations;
-    result.best_fitness = population.best_fitness();
-    result.best_individual = population.get_best();
-    
+    run.rates_ = rates_.state();
     auto end_time = std::chrono::high_resolution_clock::now();
-    result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+    run.elapsed_seconds_ += std::chrono::duration<double>(end_time - start_time).count();
     
-    return result;
+    // Solved, stopped, or we ran out of generations without a perfect solution
+    if (solved || stopped || run.generation_ >= params_.max_generations) {
+        run.finish(solved, stopped);
+    }
+    return run.finished_;
 }
 
+template<int Order>
+std::vector<BasicSolverResult<Order>> solve_batch(const std::vector<BasicSudokuGrid<Order>>& puzzles,
+                                                  const SolverParams& params) {
+    SolverParams job_params = params;
+    job_params.report_interval = 0;
+    job_params.checkpoint_path.clear();
+    
+    std::vector<BasicSolverResult<Order>> results(puzzles.size());
+    TaskGroup group;
+    for (size_t i = 0; i < puzzles.size(); ++i) {
+        group.run([&, i] {
+            BasicSolver<Order> solver(job_params);
+            results[i] = solver.solve(puzzles[i]);
+        });
+    }
+    group.wait();
+    return results;
+}
+
+template class BasicSolveRun<3>;
+template class BasicSolveRun<4>;
+template class BasicSolveRun<5>;
+template class BasicSolver<3>;
+template class BasicSolver<4>;
+template class BasicSolver<5>;
+
+template std::vector<BasicSolverResult<3>> solve_batch(const std::vector<BasicSudokuGrid<3>>&, const SolverParams&);
+template std::vector<BasicSolverResult<4>> solve_batch(const std::vector<BasicSudokuGrid<4>>&, const SolverParams&);
+template std::vector<BasicSolverResult<5>> solve_batch(const std::vector<BasicSudokuGrid<5>>&, const SolverParams&);
+
 } // namespace sudoku_ga
 
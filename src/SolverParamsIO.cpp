@@ -0,0 +1,189 @@
+#include "SolverParamsIO.hpp"
+#include "AdaptiveRates.hpp"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace sudoku_ga {
+
+namespace {
+
+std::string trim(const std::string& text) {
+    const char* whitespace = " \t\r\n";
+    size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+const char* strategy_name(LocalSearchStrategy strategy) {
+    switch (strategy) {
+        case LocalSearchStrategy::FirstImprovement: return "first_improvement";
+        case LocalSearchStrategy::SteepestAscent: return "steepest_ascent";
+        case LocalSearchStrategy::Random: break;
+    }
+    return "random";
+}
+
+// Parsers for each kind of value; return false if the text doesn't fit
+bool parse(const std::string& text, int& value) {
+    std::istringstream in(text);
+    return (in >> value) && in.eof();
+}
+
+bool parse(const std::string& text, double& value) {
+    std::istringstream in(text);
+    return (in >> value) && in.eof();
+}
+
+bool parse(const std::string& text, bool& value) {
+    if (text == "true" || text == "1") { value = true; return true; }
+    if (text == "false" || text == "0") { value = false; return true; }
+    return false;
+}
+
+bool parse(const std::string& text, std::string& value) {
+    value = text;
+    return true;
+}
+
+bool parse(const std::string& text, LocalSearchStrategy& value) {
+    if (text == "random") { value = LocalSearchStrategy::Random; return true; }
+    if (text == "first_improvement") { value = LocalSearchStrategy::FirstImprovement; return true; }
+    if (text == "steepest_ascent") { value = LocalSearchStrategy::SteepestAscent; return true; }
+    return false;
+}
+
+// A number that also has to lie in [min, max] (NaN never does)
+template<typename T>
+bool parse(const std::string& text, T& value, T min, T max) {
+    T parsed;
+    if (!parse(text, parsed) || !(parsed >= min && parsed <= max)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+constexpr int NO_LIMIT = std::numeric_limits<int>::max();
+
+// Sets the named field; false if there's no such field or the value is bad
+bool set_field(SolverParams& params, const std::string& name, const std::string& value) {
+    if (name == "population_size") return parse(value, params.population_size, 1, NO_LIMIT);
+    if (name == "max_generations") return parse(value, params.max_generations, 0, NO_LIMIT);
+    if (name == "crossover_rate") return parse(value, params.crossover_rate, 0.0, 1.0);
+    if (name == "mutation_rate") return parse(value, params.mutation_rate, 0.0, 1.0);
+    if (name == "conflict_directed_mutation") return parse(value, params.conflict_directed_mutation);
+    if (name == "tournament_size") return parse(value, params.tournament_size, 1, NO_LIMIT);
+    if (name == "local_search_candidates") {
+        return parse(value, params.local_search_candidates, 1, AdaptiveRates::MAX_LOCAL_SEARCH_CANDIDATES);
+    }
+    if (name == "use_local_search") return parse(value, params.use_local_search);
+    if (name == "local_search_strategy") return parse(value, params.local_search_strategy);
+    if (name == "local_search_whole_grid") return parse(value, params.local_search_whole_grid);
+    if (name == "local_search_elite_only") return parse(value, params.local_search_elite_only);
+    if (name == "elitism") return parse(value, params.elitism);
+    if (name == "report_interval") return parse(value, params.report_interval, 0, NO_LIMIT);
+    if (name == "adaptive_rates") return parse(value, params.adaptive_rates);
+    if (name == "checkpoint_path") return parse(value, params.checkpoint_path);
+    if (name == "checkpoint_interval") return parse(value, params.checkpoint_interval, 0, NO_LIMIT);
+    if (name == "parallel_generation") return parse(value, params.parallel_generation);
+    return false;
+}
+
+// What a field accepts, for error messages ("" for unknown names and strings)
+std::string allowed_values(const std::string& name) {
+    if (name == "crossover_rate" || name == "mutation_rate") return "a number from 0 to 1";
+    if (name == "population_size" || name == "tournament_size") return "a whole number, at least 1";
+    if (name == "max_generations" || name == "report_interval" || name == "checkpoint_interval") {
+        return "a whole number, at least 0";
+    }
+    if (name == "local_search_candidates") {
+        return "a whole number from 1 to " + std::to_string(AdaptiveRates::MAX_LOCAL_SEARCH_CANDIDATES);
+    }
+    if (name == "local_search_strategy") return "random, first_improvement or steepest_ascent";
+    for (const char* flag : {"conflict_directed_mutation", "use_local_search", "local_search_whole_grid",
+                             "local_search_elite_only", "elitism", "adaptive_rates", "parallel_generation"}) {
+        if (name == flag) return "true or false";
+    }
+    return "";
+}
+
+} // namespace
+
+SolverParams& read_solver_params(std::istream& in, SolverParams& params) {
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Line " + std::to_string(line_number) +
+                                        ": expected 'name = value'");
+        }
+
+        std::string name = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (!set_field(params, name, value)) {
+            std::string allowed = allowed_values(name);
+            throw std::invalid_argument("Line " + std::to_string(line_number) +
+                                        ": bad setting '" + name + " = " + value + "'" +
+                                        (allowed.empty() ? "" : " (expected " + allowed + ")"));
+        }
+    }
+    return params;
+}
+
+void write_solver_params(std::ostream& out, const SolverParams& params) {
+    // Enough digits that the rates read back exactly
+    std::streamsize precision = out.precision(std::numeric_limits<double>::max_digits10);
+    out << std::boolalpha
+        << "population_size = " << params.population_size << '\n'
+        << "max_generations = " << params.max_generations << '\n'
+        << "crossover_rate = " << params.crossover_rate << '\n'
+        << "mutation_rate = " << params.mutation_rate << '\n'
+        << "conflict_directed_mutation = " << params.conflict_directed_mutation << '\n'
+        << "tournament_size = " << params.tournament_size << '\n'
+        << "local_search_candidates = " << params.local_search_candidates << '\n'
+        << "use_local_search = " << params.use_local_search << '\n'
+        << "local_search_strategy = " << strategy_name(params.local_search_strategy) << '\n'
+        << "local_search_whole_grid = " << params.local_search_whole_grid << '\n'
+        << "local_search_elite_only = " << params.local_search_elite_only << '\n'
+        << "elitism = " << params.elitism << '\n'
+        << "report_interval = " << params.report_interval << '\n'
+        << "adaptive_rates = " << params.adaptive_rates << '\n'
+        << "checkpoint_path = " << params.checkpoint_path << '\n'
+        << "checkpoint_interval = " << params.checkpoint_interval << '\n'
+        << "parallel_generation = " << params.parallel_generation << '\n'
+        << std::noboolalpha;
+    out.precision(precision);
+}
+
+SolverParams load_solver_params(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open parameter file: " + path);
+    }
+    SolverParams params;
+    return read_solver_params(in, params);
+}
+
+void save_solver_params(const std::string& path, const SolverParams& params) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write parameter file: " + path);
+    }
+    write_solver_params(out, params);
+}
+
+} // namespace sudoku_ga
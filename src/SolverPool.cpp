@@ -0,0 +1,215 @@
+#include "SolverPool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sudoku_ga {
+
+template<int Order>
+BasicSolverPool<Order>::BasicSolverPool(const SolverParams& params, int workers, size_t max_queued,
+                                        AffinityPolicy affinity)
+    : params_(params)
+    , max_queued_(std::max<size_t>(max_queued, 1))
+    , affinity_(affinity)
+    , signal_(std::make_shared<SolveQueueSignal>())
+{
+    if (workers <= 0) {
+        workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < workers; ++i) {
+        workers_.emplace_back(&BasicSolverPool::worker_loop, this, static_cast<size_t>(i));
+    }
+    expiry_thread_ = std::thread(&BasicSolverPool::expiry_loop, this);
+}
+
+template<int Order>
+BasicSolverPool<Order>::~BasicSolverPool() {
+    shutdown();
+}
+
+template<int Order>
+void BasicSolverPool<Order>::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        if (shutting_down_) {
+            return;
+        }
+        shutting_down_ = true;
+
+        // Nobody will run these now
+        for (const TaskPtr& task : queue_) {
+            task->finish_unrun();
+        }
+        queue_.clear();
+    }
+    work_ready_.notify_all();
+    signal_->room_ready.notify_all();
+    expiry_ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    expiry_thread_.join();
+}
+
+template<int Order>
+size_t BasicSolverPool<Order>::queued() const {
+    std::lock_guard<std::mutex> lock(signal_->mutex);
+    auto now = SolveOptions::Clock::now();
+    return static_cast<size_t>(std::count_if(queue_.begin(), queue_.end(), [now](const TaskPtr& task) {
+        return !task->claimed && now < task->options.deadline;
+    }));
+}
+
+// Take cancelled and expired requests out of the queue (completing the
+// expired ones). Called with the lock held.
+template<int Order>
+void BasicSolverPool<Order>::remove_dead_tasks() {
+    auto now = SolveOptions::Clock::now();
+    for (const TaskPtr& task : queue_) {
+        if (now >= task->options.deadline) {
+            task->finish_unrun();
+        }
+    }
+
+    size_t before = queue_.size();
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [](const TaskPtr& task) { return task->claimed.load(); }),
+                 queue_.end());
+    if (queue_.size() != before) {
+        std::make_heap(queue_.begin(), queue_.end(), LaterFirst{});
+        signal_->room_ready.notify_all();
+    }
+}
+
+// Whether a new request fits. Dead entries only get cleared out when the
+// queue looks full, so a normal submit() doesn't scan it.
+template<int Order>
+bool BasicSolverPool<Order>::has_room() {
+    if (queue_.size() >= max_queued_) {
+        remove_dead_tasks();
+    }
+    return queue_.size() < max_queued_;
+}
+
+template<int Order>
+BasicSolveHandle<Order> BasicSolverPool<Order>::submit(const Grid& puzzle, const SolveOptions& options) {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    signal_->room_ready.wait(lock, [this] { return shutting_down_ || has_room(); });
+    return enqueue(puzzle, options, lock);
+}
+
+template<int Order>
+std::optional<BasicSolveHandle<Order>> BasicSolverPool<Order>::try_submit(const Grid& puzzle,
+                                                                          const SolveOptions& options) {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    if (!shutting_down_ && !has_room()) {
+        return std::nullopt;
+    }
+    return enqueue(puzzle, options, lock);
+}
+
+template<int Order>
+BasicSolveHandle<Order> BasicSolverPool<Order>::enqueue(const Grid& puzzle, const SolveOptions& options,
+                                                       std::unique_lock<std::mutex>& lock) {
+    if (shutting_down_) {
+        throw std::runtime_error("SolverPool has been shut down");
+    }
+
+    auto task = std::make_shared<Task>();
+    task->puzzle = puzzle;
+    task->options = options;
+    task->sequence = next_sequence_++;
+    task->queue_signal = signal_;
+
+    Handle handle;
+    handle.task_ = task;
+    handle.future_ = task->promise.get_future().share();
+
+    // The expiry thread only needs waking if this is now the first deadline
+    bool sooner = options.deadline < next_expiry_;
+    if (sooner) {
+        next_expiry_ = options.deadline;
+    }
+
+    queue_.push_back(std::move(task));
+    std::push_heap(queue_.begin(), queue_.end(), LaterFirst{});
+    lock.unlock();
+    work_ready_.notify_one();
+    if (sooner) {
+        expiry_ready_.notify_one();
+    }
+    return handle;
+}
+
+template<int Order>
+void BasicSolverPool<Order>::worker_loop(size_t index) {
+    // Pin first, so everything this worker allocates is local to its core
+    pin_current_thread(affinity_, index);
+    
+    // One solver per worker, reused for every request it runs. Workers
+    // share the params, so no progress printing and no shared checkpoint file.
+    SolverParams params = params_;
+    params.report_interval = 0;
+    params.checkpoint_path.clear();
+    BasicSolver<Order> solver(params);
+
+    while (true) {
+        TaskPtr task;
+        {
+            std::unique_lock<std::mutex> lock(signal_->mutex);
+            work_ready_.wait(lock, [this] { return shutting_down_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;   // Shutting down
+            }
+            std::pop_heap(queue_.begin(), queue_.end(), LaterFirst{});
+            task = std::move(queue_.back());
+            queue_.pop_back();
+        }
+        signal_->room_ready.notify_one();
+
+        // Don't start what's already too late. Once claimed, cancel() leaves
+        // the promise to us and the stop condition ends the solve.
+        if (task->should_stop()) {
+            task->finish_unrun();
+            continue;
+        }
+        if (task->claimed.exchange(true)) {
+            continue;   // Cancelled and completed while it waited
+        }
+
+        solver.set_stop_condition([&task, this] { return task->should_stop() || shutting_down_; });
+        try {
+            task->promise.set_value(solver.solve(task->puzzle));
+        } catch (...) {
+            task->promise.set_exception(std::current_exception());
+        }
+        solver.set_stop_condition(nullptr);
+    }
+}
+
+// Completes queued requests when their deadline passes, so nobody waits on
+// one just because every worker is busy
+template<int Order>
+void BasicSolverPool<Order>::expiry_loop() {
+    std::unique_lock<std::mutex> lock(signal_->mutex);
+    while (!shutting_down_) {
+        remove_dead_tasks();
+
+        next_expiry_ = SolveOptions::Clock::time_point::max();
+        for (const TaskPtr& task : queue_) {
+            next_expiry_ = std::min(next_expiry_, task->options.deadline);
+        }
+        if (next_expiry_ == SolveOptions::Clock::time_point::max()) {
+            expiry_ready_.wait(lock);
+        } else {
+            expiry_ready_.wait_until(lock, next_expiry_);
+        }
+    }
+}
+
+template class BasicSolverPool<3>;
+template class BasicSolverPool<4>;
+template class BasicSolverPool<5>;
+
+} // namespace sudoku_ga
@@ -1,197 +1,257 @@
 #include "SudokuGrid.hpp"
+#include "FitnessKernels.hpp"
+#include "ScratchArena.hpp"
 
 #include <algorithm>
-#include <bitset>
 #include <sstream>
 #include <stdexcept>
 
 namespace sudoku_ga {
 
 // Default constructor: all cells empty, none fixed
-SudokuGrid::SudokuGrid() {
-    for (auto& row : grid_) {
-        row.fill(0);
-    }
-    for (auto& row : fixed_) {
-        row.fill(false);
-    }
+template<int Order>
+BasicSudokuGrid<Order>::BasicSudokuGrid() {
+    cells_.fill(0);
+    fixed_.fill(false);
 }
 
 // Build grid from a string like "003020600900305001..."
-SudokuGrid::SudokuGrid(const std::string& puzzle) : SudokuGrid() {
-    if (puzzle.length() < SIZE * SIZE) {
-        throw std::invalid_argument("Puzzle string must have at least 81 characters");
+template<int Order>
+BasicSudokuGrid<Order>::BasicSudokuGrid(const std::string& puzzle) : BasicSudokuGrid() {
+    if (puzzle.length() < static_cast<size_t>(NUM_CELLS)) {
+        throw std::invalid_argument("Puzzle string must have at least " +
+                                    std::to_string(NUM_CELLS) + " characters");
     }
     
-    for (int i = 0; i < SIZE * SIZE; ++i) {
-        int row = i / SIZE;
-        int col = i % SIZE;
-        char c = puzzle[i];
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        int value = char_to_digit(puzzle[i]);
         
-        if (c >= '1' && c <= '9') {
+        if (value >= 1 && value <= SIZE) {
             // This is a given number - mark it as fixed
-            grid_[row][col] = c - '0';
-            fixed_[row][col] = true;
-        } else {
-            // Anything else (0, ., space, etc.) means empty
-            grid_[row][col] = 0;
-            fixed_[row][col] = false;
+            cells_[i] = static_cast<uint8_t>(value);
+            fixed_[i] = true;
         }
+        // Anything else (0, ., space, etc.) means empty, as already set
     }
 }
 
-// Simple getters and setters
-int SudokuGrid::get(int row, int col) const {
-    return grid_[row][col];
+// Digits 1-9 are written as themselves, 10 and up as letters (A = 10)
+template<int Order>
+char BasicSudokuGrid<Order>::digit_to_char(int value) {
+    if (value <= 0) return '.';
+    if (value <= 9) return static_cast<char>('0' + value);
+    return static_cast<char>('A' + value - 10);
 }
 
-void SudokuGrid::set(int row, int col, int value) {
-    grid_[row][col] = value;
+template<int Order>
+int BasicSudokuGrid<Order>::char_to_digit(char c) {
+    if (c >= '1' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+    return 0;
 }
 
-bool SudokuGrid::is_fixed(int row, int col) const {
-    return fixed_[row][col];
-}
-
-// Count how many unique digits (1-9) are in an array
-// We use a bitset as a fast way to track which digits we've seen
-int SudokuGrid::count_unique(const std::array<int, SIZE>& values) {
-    std::bitset<10> seen;  // Index 0 unused, 1-9 for digits
-    int count = 0;
+// Count how many unique digits are in a row or column (its cells come
+// from the geometry tables)
+// We use a bit mask as a fast way to track which digits we've seen
+template<int Order>
+int BasicSudokuGrid<Order>::count_unique(const typename Geometry::Unit& unit) const {
+    DigitMask seen = 0;  // Bit 0 unused, bits 1-SIZE for digits
     
-    for (int v : values) {
-        if (v >= 1 && v <= 9 && !seen[v]) {
-            seen[v] = true;
-            ++count;
-        }
+    for (int cell : unit) {
+        seen |= DigitMask{1} << cells_[cell];
     }
-    return count;
+    return __builtin_popcountll(seen & ~DigitMask{1});
 }
 
-// Row score = how many unique digits in that row (max 9)
-int SudokuGrid::get_row_score(int row) const {
-    return count_unique(grid_[row]);
+// Row score = how many unique digits in that row (max SIZE)
+template<int Order>
+int BasicSudokuGrid<Order>::get_row_score(int row) const {
+    return count_unique(Geometry::row_cells(row));
 }
 
-// Column score = how many unique digits in that column (max 9)
-int SudokuGrid::get_column_score(int col) const {
-    std::array<int, SIZE> column;
-    for (int row = 0; row < SIZE; ++row) {
-        column[row] = grid_[row][col];
-    }
-    return count_unique(column);
+// Column score = how many unique digits in that column (max SIZE)
+template<int Order>
+int BasicSudokuGrid<Order>::get_column_score(int col) const {
+    return count_unique(Geometry::col_cells(col));
 }
 
-// Total fitness = sum of all row scores + all column scores (max 162)
-int SudokuGrid::get_total_score() const {
-    int score = 0;
-    for (int i = 0; i < SIZE; ++i) {
-        score += get_row_score(i);
-        score += get_column_score(i);
+// Total fitness = sum of all row scores + all column scores (max MAX_SCORE)
+// This is the hot path of the GA, so 9x9 goes through the SIMD kernel
+template<int Order>
+int BasicSudokuGrid<Order>::get_total_score() const {
+    if constexpr (Order == 3) {
+        return score_grid(cells_.data());
+    } else {
+        int score = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            score += get_row_score(i);
+            score += get_column_score(i);
+        }
+        return score;
     }
-    return score;
 }
 
-// Score for 3 consecutive rows (a "band")
-// band_index 0 = rows 0-2, band_index 1 = rows 3-5, band_index 2 = rows 6-8
-int SudokuGrid::get_row_band_score(int band_index) const {
+// Score for SUBBLOCK_SIZE consecutive rows (a "band")
+// On 9x9: band_index 0 = rows 0-2, band_index 1 = rows 3-5, band_index 2 = rows 6-8
+// The band's rows are the rows of its first sub-block's first column
+template<int Order>
+int BasicSudokuGrid<Order>::get_row_band_score(int band_index) const {
+    const auto& block = Geometry::box_cells(band_index * SUBBLOCK_SIZE);
     int score = 0;
-    int start_row = band_index * SUBBLOCK_SIZE;
     
-    for (int r = start_row; r < start_row + SUBBLOCK_SIZE; ++r) {
-        score += get_row_score(r);
+    for (int i = 0; i < SIZE; i += SUBBLOCK_SIZE) {
+        score += count_unique(Geometry::row_cells(Geometry::row_of(block[i])));
     }
     return score;
 }
 
-// Score for 3 consecutive columns (a "stack")
-int SudokuGrid::get_column_stack_score(int stack_index) const {
+// Score for SUBBLOCK_SIZE consecutive columns (a "stack")
+// Its columns are the columns of its first sub-block's first row
+template<int Order>
+int BasicSudokuGrid<Order>::get_column_stack_score(int stack_index) const {
+    const auto& block = Geometry::box_cells(stack_index);
     int score = 0;
-    int start_col = stack_index * SUBBLOCK_SIZE;
     
-    for (int c = start_col; c < start_col + SUBBLOCK_SIZE; ++c) {
-        score += get_column_score(c);
+    for (int i = 0; i < SUBBLOCK_SIZE; ++i) {
+        score += count_unique(Geometry::col_cells(Geometry::col_of(block[i])));
     }
     return score;
 }
 
-// Convert sub-block index (0-8) to the top-left corner coordinates
-// Sub-blocks are numbered left-to-right, top-to-bottom:
+// Convert sub-block index to the top-left corner coordinates
+// Sub-blocks are numbered left-to-right, top-to-bottom (on 9x9):
 //   0 1 2
 //   3 4 5
 //   6 7 8
-std::pair<int, int> SudokuGrid::subblock_top_left(int subblock_index) {
-    int block_row = subblock_index / SUBBLOCK_SIZE;  // Which row of blocks (0, 1, or 2)
-    int block_col = subblock_index % SUBBLOCK_SIZE;  // Which column of blocks (0, 1, or 2)
-    return {block_row * SUBBLOCK_SIZE, block_col * SUBBLOCK_SIZE};
+template<int Order>
+std::pair<int, int> BasicSudokuGrid<Order>::subblock_top_left(int subblock_index) {
+    int corner = Geometry::box_cells(subblock_index)[0];
+    return {Geometry::row_of(corner), Geometry::col_of(corner)};
 }
 
-// Get positions of cells we're allowed to change (not fixed)
-// Returns a list of (row, col) pairs
-std::vector<std::pair<int, int>> SudokuGrid::get_subblock_non_fixed_positions(int subblock_index) const {
-    auto [top, left] = subblock_top_left(subblock_index);
-    std::vector<std::pair<int, int>> positions;
+// Get the cells we're allowed to change (not fixed)
+// Returns their flat indices, row by row
+template<int Order>
+std::pmr::vector<int> BasicSudokuGrid<Order>::get_subblock_non_fixed_cells(
+    int subblock_index, std::pmr::memory_resource* memory) const {
+    std::pmr::vector<int> cells(memory ? memory : scratch_memory());
+    cells.reserve(SIZE);
     
-    for (int r = top; r < top + SUBBLOCK_SIZE; ++r) {
-        for (int c = left; c < left + SUBBLOCK_SIZE; ++c) {
-            if (!fixed_[r][c]) {
-                positions.emplace_back(r, c);
-            }
+    for (int cell : Geometry::box_cells(subblock_index)) {
+        if (!fixed_[cell]) {
+            cells.push_back(cell);
         }
     }
-    return positions;
+    return cells;
 }
 
-// Copy 3 rows from another grid (used in crossover)
-void SudokuGrid::copy_row_band_from(const SudokuGrid& other, int band_index) {
-    int start_row = band_index * SUBBLOCK_SIZE;
+// Copy a band of rows from another grid (used in crossover)
+template<int Order>
+void BasicSudokuGrid<Order>::copy_row_band_from(const BasicSudokuGrid& other, int band_index) {
+    // The band's rows are next to each other, so it's one block of cells
+    int first = cell_index(band_index * SUBBLOCK_SIZE, 0);
+    int count = SUBBLOCK_SIZE * SIZE;
     
-    for (int r = start_row; r < start_row + SUBBLOCK_SIZE; ++r) {
-        grid_[r] = other.grid_[r];
-        fixed_[r] = other.fixed_[r];
-    }
+    std::copy_n(&other.cells_[first], count, &cells_[first]);
+    std::copy_n(&other.fixed_[first], count, &fixed_[first]);
 }
 
-// Copy 3 columns from another grid (used in crossover)
-void SudokuGrid::copy_column_stack_from(const SudokuGrid& other, int stack_index) {
-    int start_col = stack_index * SUBBLOCK_SIZE;
-    
-    for (int row = 0; row < SIZE; ++row) {
-        for (int c = start_col; c < start_col + SUBBLOCK_SIZE; ++c) {
-            grid_[row][c] = other.grid_[row][c];
-            fixed_[row][c] = other.fixed_[row][c];
+// Copy a stack of columns from another grid (used in crossover)
+// The stack is sub-blocks stack_index, stack_index + SUBBLOCK_SIZE, ...
+template<int Order>
+void BasicSudokuGrid<Order>::copy_column_stack_from(const BasicSudokuGrid& other, int stack_index) {
+    for (int block = stack_index; block < NUM_SUBBLOCKS; block += SUBBLOCK_SIZE) {
+        for (int cell : Geometry::box_cells(block)) {
+            cells_[cell] = other.cells_[cell];
+            fixed_[cell] = other.fixed_[cell];
         }
     }
 }
 
-bool SudokuGrid::is_solved() const {
+template<int Order>
+bool BasicSudokuGrid<Order>::is_solved() const {
     return get_total_score() == MAX_SCORE;
 }
 
+template<int Order>
+bool BasicSudokuGrid<Order>::solves(const BasicSudokuGrid& puzzle) const {
+    for (int cell = 0; cell < NUM_CELLS; ++cell) {
+        int value = cells_[cell];
+        if (value < 1 || value > SIZE) {
+            return false;
+        }
+        if (puzzle.cells_[cell] != 0 && puzzle.cells_[cell] != value) {
+            return false;
+        }
+    }
+
+    for (int block = 0; block < NUM_SUBBLOCKS; ++block) {
+        DigitMask seen = 0;
+        for (int cell : Geometry::box_cells(block)) {
+            seen |= DigitMask{1} << (cells_[cell] - 1);
+        }
+        if (__builtin_popcountll(seen) != SIZE) {
+            return false;
+        }
+    }
+    return is_solved();
+}
+
 // Pretty-print the grid with separators between sub-blocks
-std::ostream& operator<<(std::ostream& os, const SudokuGrid& grid) {
-    for (int row = 0; row < SudokuGrid::SIZE; ++row) {
-        // Print horizontal separator every 3 rows
-        if (row > 0 && row % SudokuGrid::SUBBLOCK_SIZE == 0) {
-            os << "------+-------+------\n";
+template<int Order>
+std::ostream& operator<<(std::ostream& os, const BasicSudokuGrid<Order>& grid) {
+    using Grid = BasicSudokuGrid<Order>;
+    
+    // On 9x9 this is "------+-------+------"
+    std::string separator(2 * Order, '-');
+    for (int block = 1; block < Order; ++block) {
+        separator += '+';
+        separator += std::string(block + 1 < Order ? 2 * Order + 1 : 2 * Order, '-');
+    }
+    
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        // Print horizontal separator between bands
+        if (row > 0 && row % Grid::SUBBLOCK_SIZE == 0) {
+            os << separator << '\n';
         }
         
-        for (int col = 0; col < SudokuGrid::SIZE; ++col) {
-            // Print vertical separator every 3 columns
-            if (col > 0 && col % SudokuGrid::SUBBLOCK_SIZE == 0) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            // Print vertical separator between stacks
+            if (col > 0 && col % Grid::SUBBLOCK_SIZE == 0) {
                 os << " |";
             }
-            
-            int val = grid.get(row, col);
-            if (val == 0) {
-                os << " .";
-            } else {
-                os << ' ' << val;
-            }
+            os << ' ' << Grid::digit_to_char(grid.get(row, col));
         }
         os << '\n';
     }
     return os;
 }
 
+template<int Order>
+std::string grid_to_string(const BasicSudokuGrid<Order>& grid) {
+    using Grid = BasicSudokuGrid<Order>;
+
+    std::string text;
+    text.reserve(Grid::NUM_CELLS);
+    for (int row = 0; row < Grid::SIZE; ++row) {
+        for (int col = 0; col < Grid::SIZE; ++col) {
+            text += Grid::digit_to_char(grid.get(row, col));
+        }
+    }
+    return text;
+}
+
+template class BasicSudokuGrid<3>;
+template class BasicSudokuGrid<4>;
+template class BasicSudokuGrid<5>;
+
+template std::ostream& operator<<(std::ostream&, const BasicSudokuGrid<3>&);
+template std::ostream& operator<<(std::ostream&, const BasicSudokuGrid<4>&);
+template std::ostream& operator<<(std::ostream&, const BasicSudokuGrid<5>&);
+
+template std::string grid_to_string(const BasicSudokuGrid<3>&);
+template std::string grid_to_string(const BasicSudokuGrid<4>&);
+template std::string grid_to_string(const BasicSudokuGrid<5>&);
+
 }  // namespace sudoku_ga
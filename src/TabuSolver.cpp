@@ -0,0 +1,161 @@
+#include "TabuSolver.hpp"
+#include "RandomUtils.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+namespace sudoku_ga {
+
+template<int Order>
+BasicTabuSolver<Order>::BasicTabuSolver(const TabuParams& params)
+    : params_(params)
+{}
+
+// The partner is stored by its position inside the sub-block (0..SIZE-1)
+template<int Order>
+int& BasicTabuSolver<Order>::tabu_entry(int cell, int partner_cell) {
+    using Geometry = typename Grid::Geometry;
+    int partner_row = Geometry::row_of(partner_cell) % Order;
+    int partner_col = Geometry::col_of(partner_cell) % Order;
+    return tabu_until_[cell * Grid::SIZE + partner_row * Order + partner_col];
+}
+
+template<int Order>
+void BasicTabuSolver<Order>::make_tabu(const CellSwap& swap, int until) {
+    tabu_entry(swap.cell1, swap.cell2) = until;
+    tabu_entry(swap.cell2, swap.cell1) = until;
+}
+
+template<int Order>
+bool BasicTabuSolver<Order>::is_tabu(const CellSwap& swap, int iteration) {
+    return tabu_entry(swap.cell1, swap.cell2) > iteration;
+}
+
+// Scan the whole neighbourhood. Ties are broken at random so repeated
+// plateaus don't always resolve the same way.
+template<int Order>
+bool BasicTabuSolver<Order>::best_move(Chromosome& current, int best_fitness, int iteration,
+                                       CellSwap& move, int& move_delta) {
+    auto& grid = current.grid();
+    move_delta = std::numeric_limits<int>::min();
+    int ties = 0;
+
+    for (const auto& cells : free_cells_) {
+        for (size_t i = 0; i < cells.size(); ++i) {
+            for (size_t j = i + 1; j < cells.size(); ++j) {
+                CellSwap swap{cells[i], cells[j]};
+                int delta = apply_swap(grid, swap);
+                swap_cells(grid, swap);
+
+                // Aspiration: a tabu move that beats the best so far is allowed
+                bool aspires = current.fitness() + delta > best_fitness;
+                if (is_tabu(swap, iteration) && !aspires) {
+                    continue;
+                }
+
+                if (delta > move_delta) {
+                    move_delta = delta;
+                    move = swap;
+                    ties = 1;
+                } else if (delta == move_delta && rng().rand_int(0, ties++) == 0) {
+                    move = swap;
+                }
+            }
+        }
+    }
+    return ties > 0;
+}
+
+template<int Order>
+void BasicTabuSolver<Order>::perturb(Chromosome& current) {
+    int fitness = current.fitness();
+    for (int i = 0; i < params_.perturb_swaps; ++i) {
+        const auto& cells = free_cells_[rng().rand_int(0, static_cast<int>(free_cells_.size()) - 1)];
+        auto [a, b] = rng().two_distinct_indices(static_cast<int>(cells.size()) - 1);
+        fitness += apply_swap(current.grid(), CellSwap{cells[a], cells[b]});
+    }
+    current.set_fitness(fitness);
+}
+
+// Main tabu search loop
+template<int Order>
+BasicSolverResult<Order> BasicTabuSolver<Order>::solve(const Grid& puzzle) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    Result result;
+
+    Chromosome current(puzzle);
+    current.initialize_random();
+    Chromosome best = current;
+
+    free_cells_.clear();
+    for (int block = 0; block < Grid::NUM_SUBBLOCKS; ++block) {
+        auto cells = puzzle.get_subblock_non_fixed_cells(block);
+        if (cells.size() >= 2) {
+            // Kept for the whole solve, so copied out of the scratch arena
+            free_cells_.emplace_back(cells.begin(), cells.end());
+        }
+    }
+    tabu_until_.assign(Grid::NUM_CELLS * Grid::SIZE, 0);
+
+    int iteration = 0;
+    int since_best = 0;
+    bool stopped = false;
+
+    while (!best.is_solution() && !free_cells_.empty() && iteration < params_.max_iterations) {
+        if (should_stop_ && should_stop_()) {
+            stopped = true;
+            break;
+        }
+        ++iteration;
+
+        CellSwap move;
+        int delta = 0;
+        if (!best_move(current, best.fitness(), iteration, move, delta)) {
+            // Everything is tabu - shake things up instead
+            perturb(current);
+            continue;
+        }
+
+        swap_cells(current.grid(), move);
+        current.set_fitness(current.fitness() + delta);
+        make_tabu(move, iteration + params_.tabu_tenure + rng().rand_int(0, params_.tenure_jitter));
+
+        if (current.fitness() > best.fitness()) {
+            best = current;
+            since_best = 0;
+        } else if (params_.perturb_after > 0 && ++since_best >= params_.perturb_after) {
+            perturb(current);
+            since_best = 0;
+        }
+
+        if (params_.report_interval > 0 && iteration % params_.report_interval == 0) {
+            std::cout << "Iteration " << iteration
+                      << " | Current: " << current.fitness()
+                      << " | Best: " << best.fitness()
+                      << std::endl;
+        }
+    }
+
+    result.solved = best.is_solution();
+    result.stopped = stopped;
+    result.generations = iteration;
+    result.best_fitness = best.fitness();
+    result.best_individual = best;
+
+    if (result.solved && params_.report_interval > 0) {
+        std::cout << "Solution found at iteration " << iteration << "!" << std::endl;
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.elapsed_seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+    return result;
+}
+
+template class BasicTabuSolver<3>;
+template class BasicTabuSolver<4>;
+template class BasicTabuSolver<5>;
+
+} // namespace sudoku_ga
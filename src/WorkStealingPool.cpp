@@ -0,0 +1,200 @@
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+
+namespace sudoku_ga {
+
+namespace {
+
+// Which pool (if any) the current thread works for, and its deque
+thread_local WorkStealingPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+std::atomic<AffinityPolicy> shared_affinity{AffinityPolicy::None};
+
+} // namespace
+
+// =============================================================================
+// WorkStealingPool
+// =============================================================================
+
+WorkStealingPool::WorkStealingPool(int workers, AffinityPolicy affinity)
+    : affinity_(affinity)
+{
+    if (workers <= 0) {
+        workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < workers; ++i) {
+        threads_.emplace_back(&WorkStealingPool::worker_loop, this, static_cast<size_t>(i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+WorkStealingPool& WorkStealingPool::shared() {
+    static WorkStealingPool pool(0, shared_affinity.load());
+    return pool;
+}
+
+void WorkStealingPool::set_shared_affinity(AffinityPolicy affinity) {
+    shared_affinity = affinity;
+}
+
+void WorkStealingPool::push(Job job) {
+    // Our own deque if we're one of the workers, otherwise spread them out
+    size_t index = current_pool == this
+        ? current_index
+        : next_victim_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->jobs.push_back(std::move(job));
+    }
+    queued_.fetch_add(1);
+
+    // Taking the lock makes sure a worker about to sleep sees the new job
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+}
+
+bool WorkStealingPool::take(Worker& worker, bool from_back, const TaskGroup* group, Job& job) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    auto& jobs = worker.jobs;
+    if (jobs.empty()) {
+        return false;
+    }
+
+    if (!group) {
+        if (from_back) {
+            job = std::move(jobs.back());
+            jobs.pop_back();
+        } else {
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+    } else {
+        auto matches = [group](const Job& candidate) { return candidate.group == group; };
+        if (from_back) {
+            auto it = std::find_if(jobs.rbegin(), jobs.rend(), matches);
+            if (it == jobs.rend()) {
+                return false;
+            }
+            job = std::move(*it);
+            jobs.erase(std::next(it).base());
+        } else {
+            auto it = std::find_if(jobs.begin(), jobs.end(), matches);
+            if (it == jobs.end()) {
+                return false;
+            }
+            job = std::move(*it);
+            jobs.erase(it);
+        }
+    }
+    queued_.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::run_one(const TaskGroup* group) {
+    if (queued_.load() == 0) {
+        return false;
+    }
+
+    Job job;
+    bool found = false;
+    size_t start = 0;
+    if (current_pool == this) {
+        found = take(*workers_[current_index], true, group, job);
+        start = current_index + 1;
+    }
+    for (size_t n = 0; n < workers_.size() && !found; ++n) {
+        found = take(*workers_[(start + n) % workers_.size()], false, group, job);
+    }
+    if (!found) {
+        return false;
+    }
+
+    job.group->execute(job.work);
+    return true;
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+    pin_current_thread(affinity_, index);
+    current_pool = this;
+    current_index = index;
+
+    while (true) {
+        if (run_one()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+// =============================================================================
+// TaskGroup
+// =============================================================================
+
+TaskGroup::~TaskGroup() {
+    // Jobs may refer to things about to be destroyed, so they must finish;
+    // an exception nobody asked for is dropped
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> work) {
+    pending_.fetch_add(1);
+    pool_.push(WorkStealingPool::Job{std::move(work), this});
+}
+
+void TaskGroup::execute(std::function<void()>& work) {
+    std::exception_ptr error;
+    try {
+        work();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Finish under the lock: once pending_ reaches zero the waiter may
+    // return and destroy the group, so we mustn't touch it after that
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error && !error_) {
+        error_ = error;
+    }
+    if (pending_.fetch_sub(1) == 1) {
+        done_.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    // Help with our own jobs while there are any left to take
+    while (pending_.load() > 0 && pool_.run_one(this)) {
+    }
+
+    // The rest are running on other threads; sleep until the last one is done
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_.load() == 0; });
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace sudoku_ga
@@ -0,0 +1,608 @@
+#include "Affinity.hpp"
+#include "Dispatcher.hpp"
+#include "Solver.hpp"
+#include "SolverParamsIO.hpp"
+#include "SudokuGrid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+ * sudoku_ga_daemon - A resident solve service on a Unix domain socket
+ *
+ * Usage:
+ *     sudoku_ga_daemon <socket-path> [options]
+ *
+ * Starting a process per puzzle pays for startup and cold caches every
+ * time. The daemon keeps worker threads (each with its own solver) warm
+ * and lets any number of clients send puzzles over a local socket.
+ *
+ * Protocol (one line each way, '\n' terminated):
+ *     request:   [id] <puzzle>
+ *     response:  <id> solved|unsolved <generations> <solve-seconds> <total-seconds> <grid>
+ *                <id> error <message>
+ *
+ * The id is optional (by default requests on a connection are numbered from
+ * 1). Responses come back as each puzzle finishes, so they may be out of
+ * order - match them up by id. total-seconds includes time spent waiting
+ * in the queue. A puzzle not solved within --time-limit of arriving is
+ * answered "unsolved" with the best attempt so far. When --max-queued
+ * requests are already waiting the answer is "<id> error busy" straight
+ * away; send it again later. A line longer than MAX_LINE_BYTES closes the
+ * connection.
+ *
+ * e.g.  echo "p1 000260701680070090..." | nc -U /tmp/sudoku.sock
+ *
+ * How it works: one I/O thread polls the socket and all connections, and
+ * turns complete lines into requests on a shared queue. Worker threads take
+ * up to --batch requests at a time (so a burst costs one wake-up, not one
+ * per puzzle), but never more than their share of the queue, so a burst
+ * is still spread over every worker. Answers go into the connection's output
+ * buffer and the I/O thread sends them when the socket has room. Client
+ * sockets are non-blocking, so a client that stops reading can't stall a
+ * worker or anyone else; once MAX_PENDING_OUTPUT bytes are waiting for it,
+ * the daemon stops reading its requests until it catches up.
+ *
+ * Options:
+ *     --workers N     worker threads (default: one per core)
+ *     --batch N       most requests a worker takes at once (default 8)
+ *     --max-queued N  requests allowed to wait for a worker (default 1024)
+ *     --time-limit S  seconds a puzzle may take, counted from its arrival
+ *                     (default 60, 0 = no limit)
+ *     --params FILE   SolverParams for the GA (see SolverParamsIO.hpp)
+ *     --dispatch      route puzzles by difficulty (see Dispatcher.hpp)
+ *                     instead of always running the GA
+ *     --affinity P    pin workers to cores: none, compact or spread
+ *                     (default none, see Affinity.hpp)
+ *
+ * SIGINT / SIGTERM stop the daemon: no new requests are read, waiting
+ * ones are answered "<id> error shutting down", the ones being solved stop
+ * at their next generation (answered "unsolved"), and every answer is sent
+ * before it exits. Clients that don't read them within
+ * SHUTDOWN_GRACE_SECONDS are dropped.
+ */
+
+using namespace sudoku_ga;
+
+namespace {
+
+std::atomic<bool> stop_requested{false};
+
+void handle_signal(int) {
+    stop_requested = true;
+}
+
+// Longest request line accepted (a 25x25 puzzle is 625 characters)
+constexpr size_t MAX_LINE_BYTES = 4096;
+
+// Unsent answers a client may have before we stop reading its requests
+constexpr size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+// How long a stopping daemon keeps trying to deliver the last answers
+constexpr int SHUTDOWN_GRACE_SECONDS = 5;
+
+struct DaemonOptions {
+    std::string socket_path;
+    int workers = 0;
+    int batch = 8;
+    int max_queued = 1024;
+    double time_limit = 60.0;   // Seconds per puzzle (0 = no limit)
+    SolverParams params;
+    bool dispatch = false;
+    AffinityPolicy affinity = AffinityPolicy::None;
+};
+
+// A client. Shared by the I/O thread and by requests still being solved.
+// Only the I/O thread touches the socket; workers leave their answers in
+// output and wake it up.
+struct Connection {
+    int fd;
+    std::string input;          // Partial line read so far (I/O thread only)
+    long next_id = 1;           // (I/O thread only)
+    bool read_closed = false;   // Client has sent everything (I/O thread only)
+
+    std::mutex mutex;           // Guards output and in_flight
+    std::string output;         // Answers not sent yet
+    size_t in_flight = 0;       // Requests queued or being solved
+
+    explicit Connection(int socket) : fd(socket) {}
+    ~Connection() { close(fd); }
+
+    // A worker's answer to one of this client's requests
+    void add_answer(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex);
+        output += line;
+        output += '\n';
+        --in_flight;
+    }
+};
+
+// Lets workers interrupt the I/O thread's poll() when there's output to send
+class Wakeup {
+public:
+    Wakeup() {
+        if (pipe(fds_) != 0) {
+            throw std::runtime_error(std::string("Cannot create pipe: ") + std::strerror(errno));
+        }
+        fcntl(fds_[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds_[1], F_SETFL, O_NONBLOCK);
+    }
+    ~Wakeup() {
+        close(fds_[0]);
+        close(fds_[1]);
+    }
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+
+    int fd() const { return fds_[0]; }
+
+    // A full pipe already means "wake up", so a failed write is fine
+    void notify() {
+        char byte = 1;
+        [[maybe_unused]] ssize_t n = write(fds_[1], &byte, 1);
+    }
+
+    void drain() {
+        char buffer[256];
+        while (read(fds_[0], buffer, sizeof(buffer)) > 0) {
+        }
+    }
+
+private:
+    int fds_[2];
+};
+
+struct Request {
+    std::shared_ptr<Connection> connection;
+    std::string id;
+    std::string puzzle;
+    std::chrono::steady_clock::time_point received;
+};
+
+// =============================================================================
+// Request queue
+// =============================================================================
+
+class RequestQueue {
+public:
+    RequestQueue(size_t max_queued, size_t workers) : max_queued_(max_queued), workers_(workers) {}
+
+    // Queue a request; false (and the request is dropped) if the queue is full
+    bool try_push(Request request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (requests_.size() >= max_queued_) {
+                return false;
+            }
+            requests_.push_back(std::move(request));
+        }
+        ready_.notify_one();
+        return true;
+    }
+
+    // Wait for work and take up to max_count requests, but no more than
+    // one worker's share of what's queued; empty once stopped
+    std::vector<Request> pop_batch(size_t max_count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+
+        size_t count = std::min(max_count, std::max<size_t>(requests_.size() / workers_, 1));
+        std::vector<Request> batch;
+        while (!requests_.empty() && batch.size() < count) {
+            batch.push_back(std::move(requests_.front()));
+            requests_.pop_front();
+        }
+        // Leave the rest for the other workers
+        if (!requests_.empty()) {
+            ready_.notify_one();
+        }
+        return batch;
+    }
+
+    // Wake every worker to exit, and hand back the requests nobody took
+    std::vector<Request> stop() {
+        std::vector<Request> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            for (Request& request : requests_) {
+                dropped.push_back(std::move(request));
+            }
+            requests_.clear();
+        }
+        ready_.notify_all();
+        return dropped;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Request> requests_;
+    size_t max_queued_;
+    size_t workers_;
+    bool stopping_ = false;
+};
+
+// =============================================================================
+// Workers
+// =============================================================================
+
+std::string solve_request(const Request& request, Solver& solver, Dispatcher& dispatcher,
+                          const DaemonOptions& options) {
+    SudokuGrid puzzle;
+    try {
+        puzzle = SudokuGrid(request.puzzle);
+    } catch (const std::exception& e) {
+        return request.id + " error " + e.what();
+    }
+
+    // Stop at the time limit, or as soon as the daemon is shutting down
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (options.time_limit > 0.0) {
+        deadline = request.received + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                          std::chrono::duration<double>(options.time_limit));
+    }
+    auto should_stop = [deadline] {
+        return stop_requested || std::chrono::steady_clock::now() >= deadline;
+    };
+
+    SolverResult result;
+    if (options.dispatch) {
+        dispatcher.set_stop_condition(should_stop);
+        result = dispatcher.solve(puzzle);
+    } else {
+        solver.set_stop_condition(should_stop);
+        result = solver.solve(puzzle);
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                 request.received).count();
+
+    std::ostringstream line;
+    line << request.id << ' ' << (result.solved ? "solved" : "unsolved") << ' '
+         << result.generations << ' ' << result.elapsed_seconds << ' ' << total << ' '
+         << grid_to_string(result.best_individual.grid());
+    return line.str();
+}
+
+void worker_loop(RequestQueue& queue, Wakeup& wakeup, const DaemonOptions& options,
+                 size_t index) {
+    // Pin before allocating, so the solvers' memory is local to the core
+    pin_current_thread(options.affinity, index);
+    
+    // Each worker has its own solvers (they keep scratch buffers between
+    // solves), and the thread has its own random generator
+    SolverParams params = options.params;
+    params.report_interval = 0;
+    Solver solver(params);
+
+    DispatchParams dispatch_params;
+    dispatch_params.hard_params.report_interval = 0;
+    dispatch_params.extreme_params.report_interval = 0;
+    dispatch_params.annealing_params.report_interval = 0;
+    dispatch_params.tabu_params.report_interval = 0;
+    Dispatcher dispatcher(dispatch_params);
+
+    while (true) {
+        std::vector<Request> batch = queue.pop_batch(static_cast<size_t>(options.batch));
+        if (batch.empty()) {
+            return;
+        }
+        for (const Request& request : batch) {
+            request.connection->add_answer(solve_request(request, solver, dispatcher, options));
+            wakeup.notify();
+        }
+    }
+}
+
+// =============================================================================
+// I/O thread
+// =============================================================================
+
+int open_listener(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        close(fd);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    unlink(path.c_str());   // A socket left behind by an earlier run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Read what's available and queue every complete line. False if the
+// connection has to be dropped (a read error or a line that's too long).
+bool read_requests(const std::shared_ptr<Connection>& connection, RequestQueue& queue) {
+    char buffer[4096];
+    ssize_t n = recv(connection->fd, buffer, sizeof(buffer), 0);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (n == 0) {
+        connection->read_closed = true;
+        return true;
+    }
+    std::string& input = connection->input;
+    input.append(buffer, static_cast<size_t>(n));
+
+    size_t newline;
+    while ((newline = input.find('\n')) != std::string::npos) {
+        if (newline > MAX_LINE_BYTES) {
+            return false;
+        }
+        std::string line = input.substr(0, newline);
+        input.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        Request request;
+        request.connection = connection;
+        request.received = std::chrono::steady_clock::now();
+        size_t space = line.find(' ');
+        if (space == std::string::npos) {
+            request.id = std::to_string(connection->next_id++);
+            request.puzzle = line;
+        } else {
+            request.id = line.substr(0, space);
+            request.puzzle = line.substr(space + 1);
+        }
+
+        std::string id = request.id;
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            ++connection->in_flight;
+        }
+        if (!queue.try_push(std::move(request))) {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            --connection->in_flight;
+            connection->output += id + " error busy\n";
+        }
+    }
+    return input.size() <= MAX_LINE_BYTES;
+}
+
+// Send as much waiting output as the socket takes. False if the client is gone.
+bool flush_output(Connection& connection) {
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t n = send(connection.fd, connection.output.data() + sent,
+                         connection.output.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;   // Socket buffer full; poll() says when there's room
+        }
+        sent += static_cast<size_t>(n);
+    }
+    connection.output.erase(0, sent);
+    return true;
+}
+
+// Runs until a stop request, then until every answer has been sent (or
+// SHUTDOWN_GRACE_SECONDS have passed)
+void serve(int listener, RequestQueue& queue, Wakeup& wakeup) {
+    std::map<int, std::shared_ptr<Connection>> connections;
+    bool stopping = false;
+    auto give_up_at = std::chrono::steady_clock::time_point::max();
+
+    while (true) {
+        if (stop_requested && !stopping) {
+            // Workers see the flag through their stop condition; the
+            // requests none of them took get an answer from here
+            stopping = true;
+            give_up_at = std::chrono::steady_clock::now() + std::chrono::seconds(SHUTDOWN_GRACE_SECONDS);
+            for (Request& request : queue.stop()) {
+                request.connection->add_answer(request.id + " error shutting down");
+            }
+        }
+        if (stopping && (connections.empty() || std::chrono::steady_clock::now() >= give_up_at)) {
+            return;
+        }
+
+        std::vector<pollfd> fds;
+        fds.push_back({listener, static_cast<short>(stopping ? 0 : POLLIN), 0});
+        fds.push_back({wakeup.fd(), POLLIN, 0});
+        for (const auto& entry : connections) {
+            Connection& connection = *entry.second;
+            size_t waiting;
+            {
+                std::lock_guard<std::mutex> lock(connection.mutex);
+                waiting = connection.output.size();
+            }
+            short events = 0;
+            if (!stopping && !connection.read_closed && waiting < MAX_PENDING_OUTPUT) {
+                events |= POLLIN;
+            }
+            if (waiting > 0) {
+                events |= POLLOUT;
+            }
+            fds.push_back({entry.first, events, 0});
+        }
+
+        // Wake up now and then to notice a stop request
+        if (poll(fds.data(), fds.size(), 200) < 0) {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK);
+                connections[client] = std::make_shared<Connection>(client);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            wakeup.drain();
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            auto it = connections.find(fds[i].fd);
+            Connection& connection = *it->second;
+            short revents = fds[i].revents;
+
+            bool keep = true;
+            if (revents & POLLIN) {
+                keep = read_requests(it->second, queue);
+            }
+            // Answers may have arrived since poll() started, so try to
+            // send whenever something is waiting
+            if (keep) {
+                keep = flush_output(connection);
+            }
+            // POLLHUP without anything left to read: the client has gone
+            // completely, so its answers can't be delivered
+            if (revents & POLLERR || (revents & POLLHUP && !(revents & POLLIN))) {
+                keep = false;
+            }
+            // Once stopping, nothing more will be read from anyone
+            if (keep && (connection.read_closed || stopping)) {
+                std::lock_guard<std::mutex> lock(connection.mutex);
+                keep = connection.in_flight > 0 || !connection.output.empty();
+            }
+            if (!keep) {
+                connections.erase(it);
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Command line
+// =============================================================================
+
+[[noreturn]] void usage_error(const std::string& message) {
+    std::cerr << "Error: " << message << "\n"
+              << "Usage: sudoku_ga_daemon <socket-path> [--workers N] [--batch N]\n"
+              << "       [--max-queued N] [--time-limit S] [--params FILE] [--dispatch]\n"
+              << "       [--affinity none|compact|spread]\n";
+    std::exit(1);
+}
+
+DaemonOptions parse_options(int argc, char* argv[]) {
+    DaemonOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dispatch") {
+            options.dispatch = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            options.socket_path = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage_error("missing value for " + arg);
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--workers") options.workers = std::stoi(value);
+            else if (arg == "--batch") options.batch = std::stoi(value);
+            else if (arg == "--max-queued") options.max_queued = std::stoi(value);
+            else if (arg == "--time-limit") options.time_limit = std::stod(value);
+            else if (arg == "--params") options.params = load_solver_params(value);
+            else if (arg == "--affinity") options.affinity = parse_affinity_policy(value);
+            else usage_error("unknown option " + arg);
+        } catch (const std::exception& e) {
+            usage_error("bad value for " + arg + ": " + e.what());
+        }
+    }
+
+    if (options.socket_path.empty()) {
+        usage_error("no socket path given");
+    }
+    if (options.workers <= 0) {
+        options.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options.batch < 1) {
+        usage_error("--batch must be at least 1");
+    }
+    if (options.max_queued < 1) {
+        usage_error("--max-queued must be at least 1");
+    }
+    if (!(options.time_limit >= 0.0)) {
+        usage_error("--time-limit must be 0 or more");
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    DaemonOptions options = parse_options(argc, argv);
+
+    int listener = open_listener(options.socket_path);
+    if (listener < 0) {
+        std::cerr << "Error: cannot listen on " << options.socket_path << ": "
+                  << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    RequestQueue queue(static_cast<size_t>(options.max_queued), static_cast<size_t>(options.workers));
+    Wakeup wakeup;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < options.workers; ++i) {
+        workers.emplace_back(worker_loop, std::ref(queue), std::ref(wakeup), std::cref(options),
+                             static_cast<size_t>(i));
+    }
+
+    std::cout << "Listening on " << options.socket_path << " with " << options.workers
+              << " workers" << std::endl;
+    // Returns once the queue is stopped and the answers are out
+    serve(listener, queue, wakeup);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    close(listener);
+    unlink(options.socket_path.c_str());
+    std::cout << "Stopped" << std::endl;
+    return 0;
+}
@@ -0,0 +1,397 @@
+#include "Difficulty.hpp"
+#include "RandomUtils.hpp"
+#include "Solver.hpp"
+#include "SolverParamsIO.hpp"
+#include "SudokuGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * sudoku_ga_tune - Find good SolverParams for a set of puzzles
+ *
+ * Usage:
+ *     sudoku_ga_tune <corpus> [options]
+ *
+ * The corpus is a text file with one 9x9 puzzle per line (81 characters,
+ * '0' or '.' for empty cells; blank lines and '#' comments are skipped).
+ *
+ * How it works ("racing"):
+ * 1. Make a set of candidate configurations: the defaults plus random
+ *    ones drawn from sensible ranges.
+ * 2. Solve the puzzles one at a time with every candidate still in the
+ *    race. Each candidate gets the same random seed for the same puzzle,
+ *    so they're compared on equal terms.
+ * 3. After a few puzzles, drop any candidate whose score (mean or p95
+ *    time-to-solution) is clearly worse than the current leader's.
+ * 4. Stop when the corpus runs out or only one candidate is left.
+ *
+ * Bad candidates get dropped after a handful of puzzles, so most of the
+ * time goes into telling the good ones apart. A run that doesn't solve the
+ * puzzle costs PAR_K times the slowest run any candidate made on that
+ * puzzle (the usual "PAR-k" score). Every failure on a puzzle costs the
+ * same, so giving up quickly never beats solving slowly.
+ *
+ * The winner is written as a parameter file that main (or any program
+ * using load_solver_params) can read back. It keeps the race's generation
+ * cap, since that's the cap it was scored with.
+ *
+ * With --by-difficulty the corpus is split with estimate_difficulty() and
+ * each bucket gets its own race, run on the propagated puzzles just like
+ * Dispatcher does. Easy and medium puzzles are skipped (propagation solves
+ * them, no GA needed); the hard and extreme winners go to
+ * <output>_hard and <output>_extreme (before the extension), ready for
+ * DispatchParams::hard_params and extreme_params.
+ *
+ * Options:
+ *     --candidates N       number of configurations to race (default 20)
+ *     --objective mean|p95 what to minimize (default mean)
+ *     --max-generations G  generation cap for each run and in the output (default 2000)
+ *     --min-rounds R       puzzles before anyone is dropped (default 5)
+ *     --tolerance T        drop if score > leader * (1 + T) (default 0.25)
+ *     --passes P           how many times to go through the corpus (default 1)
+ *     --seed S             seed for candidates and runs (default 1)
+ *     --output FILE        where to write the winner (default tuned_params.txt)
+ *     --by-difficulty      race hard and extreme puzzles separately
+ */
+
+using namespace sudoku_ga;
+
+namespace {
+
+// An unsolved run costs PAR_K times the slowest run on that puzzle
+constexpr double PAR_K = 10.0;
+
+enum class Objective { Mean, P95 };
+
+struct TuneOptions {
+    std::string corpus_path;
+    std::string output_path = "tuned_params.txt";
+    int candidates = 20;
+    Objective objective = Objective::Mean;
+    int max_generations = 2000;
+    int min_rounds = 5;
+    double tolerance = 0.25;
+    int passes = 1;
+    unsigned int seed = 1;
+    bool by_difficulty = false;
+};
+
+struct Candidate {
+    SolverParams params;
+    std::vector<double> times;   // cost of each run so far
+    int solved = 0;
+    bool alive = true;
+};
+
+// =============================================================================
+// Command line and corpus
+// =============================================================================
+
+[[noreturn]] void usage_error(const std::string& message) {
+    std::cerr << "Error: " << message << "\n"
+              << "Usage: sudoku_ga_tune <corpus> [--candidates N] [--objective mean|p95]\n"
+              << "       [--max-generations G] [--min-rounds R] [--tolerance T]\n"
+              << "       [--passes P] [--seed S] [--output FILE] [--by-difficulty]\n";
+    std::exit(1);
+}
+
+TuneOptions parse_options(int argc, char* argv[]) {
+    TuneOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            options.corpus_path = arg;
+            continue;
+        }
+        if (arg == "--by-difficulty") {
+            options.by_difficulty = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage_error("missing value for " + arg);
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--candidates") options.candidates = std::stoi(value);
+            else if (arg == "--max-generations") options.max_generations = std::stoi(value);
+            else if (arg == "--min-rounds") options.min_rounds = std::stoi(value);
+            else if (arg == "--tolerance") options.tolerance = std::stod(value);
+            else if (arg == "--passes") options.passes = std::stoi(value);
+            else if (arg == "--seed") options.seed = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--output") options.output_path = value;
+            else if (arg == "--objective") {
+                if (value == "mean") options.objective = Objective::Mean;
+                else if (value == "p95") options.objective = Objective::P95;
+                else usage_error("objective must be mean or p95");
+            }
+            else usage_error("unknown option " + arg);
+        } catch (const std::logic_error&) {
+            usage_error("bad value for " + arg + ": " + value);
+        }
+    }
+
+    if (options.corpus_path.empty()) {
+        usage_error("no corpus file given");
+    }
+    if (options.candidates < 1 || options.passes < 1) {
+        usage_error("--candidates and --passes must be at least 1");
+    }
+    return options;
+}
+
+std::vector<SudokuGrid> load_corpus(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open corpus: " + path);
+    }
+
+    std::vector<SudokuGrid> puzzles;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        puzzles.emplace_back(line);
+    }
+    return puzzles;
+}
+
+// =============================================================================
+// Candidates and scoring
+// =============================================================================
+
+// A random configuration from ranges that are known to be reasonable
+SolverParams random_params(const SolverParams& base) {
+    auto& r = rng();
+    SolverParams params = base;
+
+    params.population_size = r.rand_int(5, 40) * 10;
+    params.crossover_rate = 0.05 + 0.85 * r.rand_double();
+    params.mutation_rate = 0.05 + 0.85 * r.rand_double();
+    params.tournament_size = r.rand_int(2, 8);
+    params.local_search_candidates = r.rand_int(1, 10);
+    params.elitism = r.rand_double() < 0.8;
+    params.conflict_directed_mutation = r.rand_double() < 0.5;
+    params.adaptive_rates = r.rand_double() < 0.5;
+    params.local_search_strategy = static_cast<LocalSearchStrategy>(r.rand_int(0, 2));
+
+    // A random-swap local search with one candidate never swaps anything
+    if (params.local_search_strategy == LocalSearchStrategy::Random) {
+        params.local_search_candidates = std::max(params.local_search_candidates, 2);
+    }
+    return params;
+}
+
+// Mean, or the 95th percentile (nearest rank) of the costs so far
+double score(const std::vector<double>& times, Objective objective) {
+    if (times.empty()) {
+        return 0.0;
+    }
+    if (objective == Objective::Mean) {
+        double sum = 0.0;
+        for (double t : times) {
+            sum += t;
+        }
+        return sum / times.size();
+    }
+
+    std::vector<double> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = static_cast<size_t>(std::ceil(0.95 * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+// Index of the alive candidate with the lowest score
+size_t leader(const std::vector<Candidate>& candidates, Objective objective) {
+    size_t best = 0;
+    bool found = false;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (!candidates[i].alive) {
+            continue;
+        }
+        if (!found || score(candidates[i].times, objective) < score(candidates[best].times, objective)) {
+            best = i;
+            found = true;
+        }
+    }
+    return best;
+}
+
+// =============================================================================
+// The race
+// =============================================================================
+
+void run_race(std::vector<Candidate>& candidates, const std::vector<SudokuGrid>& puzzles,
+              const TuneOptions& options) {
+    int alive = static_cast<int>(candidates.size());
+    int round = 0;
+
+    for (int pass = 0; pass < options.passes && alive > 1; ++pass) {
+        for (size_t p = 0; p < puzzles.size() && alive > 1; ++p) {
+            ++round;
+
+            // Run everyone first: the penalty depends on the slowest run
+            std::vector<SolverResult> results(candidates.size());
+            double slowest = 0.0;
+            for (size_t c = 0; c < candidates.size(); ++c) {
+                if (!candidates[c].alive) {
+                    continue;
+                }
+                // Same seed for every candidate on this puzzle
+                rng().seed(options.seed + round);
+
+                Solver solver(candidates[c].params);
+                results[c] = solver.solve(puzzles[p]);
+                slowest = std::max(slowest, results[c].elapsed_seconds);
+            }
+
+            for (size_t c = 0; c < candidates.size(); ++c) {
+                if (!candidates[c].alive) {
+                    continue;
+                }
+                if (results[c].solved) {
+                    ++candidates[c].solved;
+                    candidates[c].times.push_back(results[c].elapsed_seconds);
+                } else {
+                    candidates[c].times.push_back(PAR_K * slowest);
+                }
+            }
+
+            if (round < options.min_rounds) {
+                continue;
+            }
+
+            // Drop everyone clearly behind the leader
+            double best = score(candidates[leader(candidates, options.objective)].times,
+                                options.objective);
+            for (auto& candidate : candidates) {
+                if (candidate.alive &&
+                    score(candidate.times, options.objective) > best * (1.0 + options.tolerance)) {
+                    candidate.alive = false;
+                    --alive;
+                }
+            }
+
+            std::cout << "Round " << round << " | Candidates left: " << alive
+                      << " | Leader score: " << best << " s" << std::endl;
+        }
+    }
+}
+
+// Race fresh candidates on the puzzles and save the winner. Returns false
+// if the winner couldn't be saved.
+bool tune(const std::vector<SudokuGrid>& puzzles, const TuneOptions& options,
+          const std::string& output_path) {
+    // Candidate 0 is always the defaults, so the winner is never worse
+    // than what you'd get without tuning (on this corpus)
+    SolverParams base;
+    base.max_generations = options.max_generations;
+    base.report_interval = 0;
+
+    // Same seed each time, so every bucket races the same candidates
+    rng().seed(options.seed);
+    std::vector<Candidate> candidates(options.candidates);
+    candidates[0].params = base;
+    for (size_t i = 1; i < candidates.size(); ++i) {
+        candidates[i].params = random_params(base);
+    }
+
+    std::cout << "Racing " << candidates.size() << " configurations on "
+              << puzzles.size() << " puzzles..." << std::endl;
+    run_race(candidates, puzzles, options);
+
+    const Candidate& winner = candidates[leader(candidates, options.objective)];
+    // Silence was only for the race; the generation cap stays, since
+    // that's what the winner was scored with
+    SolverParams tuned = winner.params;
+    tuned.report_interval = SolverParams().report_interval;
+
+    std::cout << "\nBest configuration (" << (options.objective == Objective::Mean ? "mean" : "p95")
+              << " " << score(winner.times, options.objective) << " s, solved "
+              << winner.solved << "/" << winner.times.size() << "):\n";
+    write_solver_params(std::cout, tuned);
+
+    try {
+        save_solver_params(output_path, tuned);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
+    std::cout << "\nSaved to " << output_path << "\n";
+    return true;
+}
+
+// "tuned.txt" + "hard" -> "tuned_hard.txt"
+std::string bucket_path(const std::string& path, const std::string& bucket) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + "_" + bucket;
+    }
+    return path.substr(0, dot) + "_" + bucket + path.substr(dot);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    TuneOptions options = parse_options(argc, argv);
+
+    std::vector<SudokuGrid> puzzles;
+    try {
+        puzzles = load_corpus(options.corpus_path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (puzzles.empty()) {
+        std::cerr << "Error: no puzzles in " << options.corpus_path << "\n";
+        return 1;
+    }
+
+    if (!options.by_difficulty) {
+        return tune(puzzles, options, options.output_path) ? 0 : 1;
+    }
+
+    // Split the corpus the way Dispatcher would, keeping the propagated
+    // puzzles since that's what its GA actually gets to solve
+    std::vector<SudokuGrid> hard;
+    std::vector<SudokuGrid> extreme;
+    int skipped = 0;
+    for (const auto& puzzle : puzzles) {
+        DifficultyReport report = estimate_difficulty(puzzle);
+        if (report.level == DifficultyLevel::Hard) {
+            hard.push_back(report.propagated);
+        } else if (report.level == DifficultyLevel::Extreme && !report.contradiction) {
+            extreme.push_back(report.propagated);
+        } else {
+            ++skipped;
+        }
+    }
+    std::cout << "Buckets: " << hard.size() << " hard, " << extreme.size() << " extreme, "
+              << skipped << " skipped (solved by propagation or contradictory)" << std::endl;
+    if (hard.empty() && extreme.empty()) {
+        std::cerr << "Error: no hard or extreme puzzles in " << options.corpus_path << "\n";
+        return 1;
+    }
+
+    bool ok = true;
+    for (DifficultyLevel level : {DifficultyLevel::Hard, DifficultyLevel::Extreme}) {
+        const auto& bucket = level == DifficultyLevel::Hard ? hard : extreme;
+        if (bucket.empty()) {
+            continue;
+        }
+        std::string name = difficulty_level_name(level);
+        std::cout << "\n=== " << name << " ===" << std::endl;
+        ok = tune(bucket, options, bucket_path(options.output_path, name)) && ok;
+    }
+    return ok ? 0 : 1;
+}